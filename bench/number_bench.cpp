@@ -0,0 +1,80 @@
+// Number formatting cost: snprintf("%g"), which the formatter used for ratings
+// before, against std::to_chars on 5M doubles, then whole-export time for 500k
+// records with one-decimal ratings in every format. Prints the best of a few
+// rounds in milliseconds.
+#include "output/Formatter.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr size_t VALUE_COUNT = 5000000;
+    constexpr size_t RECORD_COUNT = 500000;
+    constexpr int ROUNDS = 3;
+
+    template <typename Run>
+    double best_ms(Run run) {
+        double best = 1e300;
+        for (int round = 0; round < ROUNDS; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        return best;
+    }
+}
+
+int main() {
+    std::mt19937 random(11);
+
+    // Ratings as the API reports them, and arbitrary doubles
+    std::vector<double> ratings(VALUE_COUNT);
+    std::vector<double> doubles(VALUE_COUNT);
+    std::uniform_real_distribution<double> spread(-1e6, 1e6);
+    for (size_t i = 0; i < VALUE_COUNT; ++i) {
+        ratings[i] = static_cast<int>(random() % 51) / 10.0;
+        doubles[i] = spread(random);
+    }
+
+    size_t total = 0;
+    char buffer[32];
+    for (const auto* values : {&ratings, &doubles}) {
+        double printf_ms = best_ms([&] {
+            for (double value : *values) {
+                total += static_cast<size_t>(std::snprintf(buffer, sizeof(buffer), "%g", value));
+            }
+        });
+        double to_chars_ms = best_ms([&] {
+            for (double value : *values) {
+                total += static_cast<size_t>(std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+            }
+        });
+        std::cout << VALUE_COUNT / 1000000 << "M " << (values == &ratings ? "ratings" : "doubles") << ": snprintf %g "
+                  << static_cast<int>(printf_ms) << " ms, to_chars " << static_cast<int>(to_chars_ms) << " ms\n";
+    }
+
+    std::vector<Business> businesses(RECORD_COUNT);
+    for (size_t i = 0; i < RECORD_COUNT; ++i) {
+        businesses[i].set_name("Business " + std::to_string(i));
+        businesses[i].set_address(std::to_string(i % 500) + " Main St, Berlin");
+        businesses[i].set_rating(static_cast<int>(random() % 51) / 10.0);
+        businesses[i].set_total_ratings(static_cast<int>(random() % 10000));
+    }
+
+    const char* const NAMES[] = {"csv", "json", "yaml", "xml", "jsonl"};
+    for (int format = 0; format < 5; ++format) {
+        Formatter formatter(static_cast<OutputFormat>(format));
+        formatter.set_threads(1);
+        double ms = best_ms([&] { total += formatter.format_businesses(businesses).size(); });
+        std::cout << RECORD_COUNT / 1000 << "k records, " << NAMES[format] << ", one thread: " << static_cast<int>(ms)
+                  << " ms\n";
+    }
+
+    // Keeps the conversions from being optimised away
+    return total == 0 ? 1 : 0;
+}
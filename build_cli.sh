@@ -17,9 +17,34 @@ if ! pkg-config --exists jsoncpp; then
     exit 1
 fi
 
+if ! pkg-config --exists sqlite3; then
+    echo "Error: SQLite development package not found. Please install libsqlite3-dev"
+    exit 1
+fi
+
+if ! pkg-config --exists zlib; then
+    echo "Error: zlib development package not found. Please install zlib1g-dev"
+    exit 1
+fi
+
 # Get library flags
 CURL_FLAGS=$(pkg-config --cflags --libs libcurl)
 JSONCPP_FLAGS=$(pkg-config --cflags --libs jsoncpp)
+SQLITE_FLAGS=$(pkg-config --cflags --libs sqlite3)
+ZLIB_FLAGS=$(pkg-config --cflags --libs zlib)
+
+# Optional features
+EXTRA_FLAGS=""
+if [ "$ENABLE_TRACING" = "1" ]; then
+    echo "Tracing enabled"
+    EXTRA_FLAGS="$EXTRA_FLAGS -DBUSINESS_SCRAPER_TRACING"
+fi
+ZSTD_FLAGS=""
+if pkg-config --exists libzstd; then
+    echo "zstd compression enabled"
+    EXTRA_FLAGS="$EXTRA_FLAGS -DBUSINESS_SCRAPER_ZSTD"
+    ZSTD_FLAGS=$(pkg-config --cflags --libs libzstd)
+fi
 
 # Create build directory if it doesn't exist
 if [ ! -d "build" ]; then
@@ -29,16 +54,31 @@ fi
 echo "Compiling with g++..."
 
 # Compile with g++
-g++ -std=c++17 -Wall -Wextra -Iinclude \
+g++ -std=c++17 -Wall -Wextra -Iinclude $EXTRA_FLAGS \
     src/core/Business.cpp \
     src/core/BusinessScraperEngine.cpp \
+    src/core/ChangeDetector.cpp \
+    src/core/Checkpoint.cpp \
+    src/core/EntityResolver.cpp \
+    src/core/GeoIndex.cpp \
+    src/core/Metrics.cpp \
+    src/core/ResultSpill.cpp \
+    src/core/ScratchArena.cpp \
+    src/core/Trace.cpp \
     src/scrapers/MapScraper.cpp \
     src/scrapers/WebScraper.cpp \
+    src/output/CompressedSink.cpp \
+    src/output/EscapeScan.cpp \
     src/output/Formatter.cpp \
+    src/output/IncrementalWriter.cpp \
+    src/output/OutputSink.cpp \
+    src/output/ParquetWriter.cpp \
     src/utils/ConfigManager.cpp \
     src/utils/FileUtils.cpp \
+    src/storage/RecordFile.cpp \
+    src/storage/ResultStore.cpp \
     src/main_cli.cpp \
-    $CURL_FLAGS $JSONCPP_FLAGS \
+    $CURL_FLAGS $JSONCPP_FLAGS $SQLITE_FLAGS $ZLIB_FLAGS $ZSTD_FLAGS -pthread \
     -o build/business_scraper
 
 if [ $? -eq 0 ]; then
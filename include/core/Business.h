@@ -1,8 +1,11 @@
 #ifndef BUSINESS_H
 #define BUSINESS_H
 
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include <utility>
 
 
 class Business {
@@ -10,7 +13,11 @@ private:
 
     int m_total_ratings;
     double m_rating;
+    double m_latitude;
+    double m_longitude;
+    int64_t m_fetched_at;
 
+    std::string m_place_id;
     std::string m_name;
     std::string m_address;
     std::string m_phone_number;
@@ -25,37 +32,47 @@ public:
     Business();
     ~Business();
 
+    // Declared explicitly: the user-declared destructor would otherwise suppress moves
+    Business(const Business&) = default;
+    Business(Business&&) noexcept = default;
+    Business& operator=(const Business&) = default;
+    Business& operator=(Business&&) noexcept = default;
+
+    // Place ID
+    const std::string& place_id() const { return m_place_id; }
+    void set_place_id(std::string place_id) { m_place_id = std::move(place_id); }
+
     // Name
-    std::string name() const { return m_name; }
-    void set_name(const std::string& name) { m_name = name; }
+    const std::string& name() const { return m_name; }
+    void set_name(std::string name) { m_name = std::move(name); }
 
     // Address
-    std::string address() const { return m_address; }
-    void set_address(const std::string& address) { m_address = address; }
+    const std::string& address() const { return m_address; }
+    void set_address(std::string address) { m_address = std::move(address); }
 
     // Phone Number
-    std::string phone_number() const { return m_phone_number; }
-    void set_phone_number(const std::string& phone_number) { m_phone_number = phone_number; }
+    const std::string& phone_number() const { return m_phone_number; }
+    void set_phone_number(std::string phone_number) { m_phone_number = std::move(phone_number); }
 
     // Email
-    std::string email() const { return m_email; }
-    void set_email(const std::string& email) { m_email = email; }
+    const std::string& email() const { return m_email; }
+    void set_email(std::string email) { m_email = std::move(email); }
 
     // Website
-    std::string website() const { return m_website; }
-    void set_website(const std::string& website) { m_website = website; }
+    const std::string& website() const { return m_website; }
+    void set_website(std::string website) { m_website = std::move(website); }
 
     // Additional Numbers
-    std::vector<std::string> additional_numbers() const { return m_additional_numbers; }
-    void set_additional_numbers(const std::vector<std::string>& numbers) { m_additional_numbers = numbers; }
+    const std::vector<std::string>& additional_numbers() const { return m_additional_numbers; }
+    void set_additional_numbers(std::vector<std::string> numbers) { m_additional_numbers = std::move(numbers); }
 
     // Additional Emails
-    std::vector<std::string> additional_emails() const { return m_additional_emails; }
-    void set_additional_emails(const std::vector<std::string>& emails) { m_additional_emails = emails; }
+    const std::vector<std::string>& additional_emails() const { return m_additional_emails; }
+    void set_additional_emails(std::vector<std::string> emails) { m_additional_emails = std::move(emails); }
 
     // Social Media Links
-    std::vector<std::string> social_media_links() const { return m_social_media_links; }
-    void set_social_media_links(const std::vector<std::string>& links) { m_social_media_links = links; }
+    const std::vector<std::string>& social_media_links() const { return m_social_media_links; }
+    void set_social_media_links(std::vector<std::string> links) { m_social_media_links = std::move(links); }
 
     // Total Ratings
     int total_ratings() const { return m_total_ratings; }
@@ -65,10 +82,20 @@ public:
     double rating() const { return m_rating; }
     void set_rating(double rating) { m_rating = rating; }
 
+    // Coordinates (NaN when the source did not provide them)
+    double latitude() const { return m_latitude; }
+    double longitude() const { return m_longitude; }
+    bool has_coordinates() const { return !std::isnan(m_latitude) && !std::isnan(m_longitude); }
+    void set_coordinates(double latitude, double longitude) { m_latitude = latitude; m_longitude = longitude; }
+
+    // Unix time of the last details fetch (0 when unknown)
+    int64_t fetched_at() const { return m_fetched_at; }
+    void set_fetched_at(int64_t fetched_at) { m_fetched_at = fetched_at; }
+
     // Utilities
-    void add_additional_number(std::string& phone_number) { m_additional_numbers.push_back(phone_number); }
-    void add_additional_email (std::string& email) { m_additional_emails.push_back(email); }
-    void add_social_link (std::string& social_link) { m_social_media_links.push_back(social_link); }
+    void add_additional_number(std::string phone_number) { m_additional_numbers.push_back(std::move(phone_number)); }
+    void add_additional_email(std::string email) { m_additional_emails.push_back(std::move(email)); }
+    void add_social_link(std::string social_link) { m_social_media_links.push_back(std::move(social_link)); }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,156 @@
+#ifndef BUSINESS_FIELDS_H
+#define BUSINESS_FIELDS_H
+
+#include <cstddef>
+#include <string_view>
+
+// The exported fields of a business, described once. Each entry gives the
+// field's key (JSON/YAML/XML name), its display label (CSV header, GUI), its
+// value type and, for lists, the XML element of one item.
+//
+// Formats walk the fields with for_each_field / for_each_value, passing a
+// generic visitor; each field arrives as its own Field<Id> type, so the visitor
+// picks what to do per field with if constexpr and nothing is dispatched at
+// run time. Adding a field means one entry here, one case in value(), and its
+// place in AllFields.
+//
+// A selection chosen at run time (see Formatter::set_fields) goes through
+// visit_field, which switches on the id once per field and then runs the same
+// compile-time code.
+namespace BusinessFields {
+    enum class FieldType {
+        String,
+        Double,
+        Int,
+        StringList
+    };
+
+    // Indexes into FIELDS
+    enum class FieldId {
+        Name,
+        Address,
+        PhoneNumber,
+        Email,
+        Website,
+        Rating,
+        TotalRatings,
+        AdditionalNumbers,
+        AdditionalEmails,
+        SocialMediaLinks
+    };
+
+    struct FieldInfo {
+        std::string_view key;
+        std::string_view label;
+        FieldType type;
+        std::string_view item;   // XML element per list item; empty for scalars
+    };
+
+    inline constexpr FieldInfo FIELDS[] = {
+        {"name", "Name", FieldType::String, ""},
+        {"address", "Address", FieldType::String, ""},
+        {"phone_number", "Phone Number", FieldType::String, ""},
+        {"email", "Email", FieldType::String, ""},
+        {"website", "Website", FieldType::String, ""},
+        {"rating", "Rating", FieldType::Double, ""},
+        {"total_ratings", "Total Ratings", FieldType::Int, ""},
+        {"additional_numbers", "Additional Numbers", FieldType::StringList, "number"},
+        {"additional_emails", "Additional Emails", FieldType::StringList, "email"},
+        {"social_media_links", "Social Media Links", FieldType::StringList, "link"},
+    };
+
+    inline constexpr size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+    constexpr const FieldInfo& info(FieldId id) { return FIELDS[static_cast<size_t>(id)]; }
+
+    // The field's value as the record's accessor returns it
+    template <FieldId Id, typename Record>
+    decltype(auto) value(const Record& record) {
+        if constexpr (Id == FieldId::Name) return record.name();
+        else if constexpr (Id == FieldId::Address) return record.address();
+        else if constexpr (Id == FieldId::PhoneNumber) return record.phone_number();
+        else if constexpr (Id == FieldId::Email) return record.email();
+        else if constexpr (Id == FieldId::Website) return record.website();
+        else if constexpr (Id == FieldId::Rating) return record.rating();
+        else if constexpr (Id == FieldId::TotalRatings) return record.total_ratings();
+        else if constexpr (Id == FieldId::AdditionalNumbers) return record.additional_numbers();
+        else if constexpr (Id == FieldId::AdditionalEmails) return record.additional_emails();
+        else {
+            static_assert(Id == FieldId::SocialMediaLinks, "every FieldId needs an accessor");
+            return record.social_media_links();
+        }
+    }
+
+    // One field as a type, for visitors
+    template <FieldId Id>
+    struct Field {
+        static constexpr FieldId id = Id;
+        static constexpr FieldType type = BusinessFields::info(Id).type;
+        static constexpr std::string_view key = BusinessFields::info(Id).key;
+        static constexpr std::string_view label = BusinessFields::info(Id).label;
+        static constexpr std::string_view item = BusinessFields::info(Id).item;
+
+        template <typename Record>
+        static decltype(auto) get(const Record& record) { return value<Id>(record); }
+    };
+
+    // An ordered selection of fields
+    template <FieldId... Ids>
+    struct FieldList {
+        static constexpr size_t size = sizeof...(Ids);
+    };
+
+    // Every exported field, in output order
+    using AllFields = FieldList<FieldId::Name, FieldId::Address, FieldId::PhoneNumber, FieldId::Email,
+                                FieldId::Website, FieldId::Rating, FieldId::TotalRatings,
+                                FieldId::AdditionalNumbers, FieldId::AdditionalEmails,
+                                FieldId::SocialMediaLinks>;
+    static_assert(AllFields::size == FIELD_COUNT, "AllFields must list every field");
+
+    // Calls visit(Field<Id>()) for each field of the list, in order
+    template <typename Visitor, FieldId... Ids>
+    void for_each_field(Visitor&& visit, FieldList<Ids...>) {
+        (visit(Field<Ids>()), ...);
+    }
+
+    template <typename Visitor>
+    void for_each_field(Visitor&& visit) {
+        for_each_field(visit, AllFields());
+    }
+
+    // Calls visit(Field<id>()) for a field chosen at run time, such as one of a
+    // user's column selection; the visitor is instantiated for every field
+    template <typename Visitor, FieldId... Ids>
+    void visit_field(FieldId id, Visitor&& visit, FieldList<Ids...>) {
+        ((id == Ids ? (visit(Field<Ids>()), true) : false) || ...);
+    }
+
+    template <typename Visitor>
+    void visit_field(FieldId id, Visitor&& visit) {
+        visit_field(id, visit, AllFields());
+    }
+
+    // Looks a field up by its key ("phone_number"); false if there is none
+    inline bool find_field(std::string_view key, FieldId& id) {
+        for (size_t i = 0; i < FIELD_COUNT; ++i) {
+            if (FIELDS[i].key == key) {
+                id = static_cast<FieldId>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Calls visit(Field<Id>(), value) for each field of the list, in order
+    template <typename Record, typename Visitor, FieldId... Ids>
+    void for_each_value(const Record& record, Visitor&& visit, FieldList<Ids...>) {
+        (visit(Field<Ids>(), value<Ids>(record)), ...);
+    }
+
+    template <typename Record, typename Visitor>
+    void for_each_value(const Record& record, Visitor&& visit) {
+        for_each_value(record, visit, AllFields());
+    }
+}
+
+#endif
@@ -4,8 +4,16 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include "core/Business.h"
+#include "core/Metrics.h"
+#include "core/ChangeDetector.h"
+#include "storage/ResultStore.h"
 #include "output/Formatter.h"
+#include "output/CompressedSink.h"
+
+class ResultSpill;
 
 // Structure to hold search parameters
 struct SearchOptions {
@@ -14,6 +22,26 @@ struct SearchOptions {
     int max_radius = 5000;
     int max_results = 20;
     bool enhance_with_web_scraping = true;
+    bool merge_duplicates = false;  // Merge records that describe the same business
+    bool merge_similar_names = false;  // Merge near-identical names at the same address or phone
+    double merge_nearby_meters = 0.0;  // Merge similar names within this distance (0 disables)
+};
+
+// Structure to hold a batch of searches run on shared resources
+struct BatchOptions {
+    std::vector<SearchOptions> jobs;
+    int max_concurrency = 4;
+    std::string checkpoint_filename;  // Journal progress here and resume from it if it exists
+    size_t memory_budget_bytes = 0;   // Spill results to disk beyond this (0 keeps everything in memory)
+    std::string spill_filename;       // Spill file location (default: system temp directory)
+    bool merge_duplicates = false;    // Merge records that describe the same business
+    bool merge_similar_names = false; // Merge near-identical names at the same address or phone
+    double merge_nearby_meters = 0.0; // Merge similar names within this distance (0 disables)
+
+    // Called with each business as it joins the results, including ones
+    // restored from the checkpoint and before any merging; calls are
+    // serialized, but come from worker threads
+    std::function<void(const Business&)> result_callback;
 };
 
 // Structure to hold results
@@ -23,6 +51,21 @@ struct SearchResults {
     std::string error_message;
     int total_found = 0;
     int enhanced_count = 0;
+    int jobs_completed = 0;
+    int duplicates_skipped = 0;
+    int resumed_count = 0;
+    int merged_count = 0;
+    int similar_names_merged = 0;
+    int nearby_merged = 0;
+    int refreshed_count = 0;  // Refresh mode: stale records fetched again
+    int reused_count = 0;     // Refresh mode: records still within their TTL
+
+    // Batch jobs (0-based) whose search area holds at least as many results as
+    // one query can return; they should be split into smaller tiles
+    std::vector<int> saturated_jobs;
+
+    // Memory-bounded runs keep their businesses here instead of in 'businesses'
+    std::shared_ptr<ResultSpill> spill;
 };
 
 class BusinessScraperEngine {
@@ -37,15 +80,88 @@ public:
     // Main functionality
     SearchResults search_businesses(const SearchOptions& options);
 
+    // Runs every job concurrently (up to max_concurrency) and deduplicates
+    // businesses across jobs by place ID into one combined result set
+    SearchResults search_batch(const BatchOptions& options);
+
+    // Brings a previous result set up to date. The search pages are read again to
+    // find new place IDs, but details and websites are fetched only for new
+    // records and for previous ones older than ttl_seconds; fresh records are
+    // reused as they are. API calls scale with churn rather than dataset size.
+    // Records are matched by place ID, so every previous record needs one
+    // (binary records and result stores keep them; text outputs do not).
+    SearchResults refresh_results(const SearchOptions& options, const SearchResults& previous, int64_t ttl_seconds);
+
+    // Merges records for the same business (see EntityResolver); returns the merge count.
+    // Spilled result sets are left untouched.
+    int merge_duplicates(SearchResults& results);
+
+    // Fuzzy counterpart of merge_duplicates for names that differ slightly
+    // (see EntityResolver::resolve_similar_names); returns the merge count.
+    int merge_similar_names(SearchResults& results);
+
+    // Merges similar names within max_distance_meters of each other
+    // (see EntityResolver::resolve_nearby); returns the merge count.
+    int merge_nearby(SearchResults& results, double max_distance_meters);
+
     // Status callbacks (for GUI status updates)
     void set_status_callback(std::function<void(const std::string&)> callback);
 
-    // Output generation
+    // Fields written by format_results, write_results and save_results, in
+    // this order; empty (the default) writes all of them
+    void set_output_fields(std::vector<BusinessFields::FieldId> fields) { m_output_fields = std::move(fields); }
+    const std::vector<BusinessFields::FieldId>& output_fields() const { return m_output_fields; }
+
+    // Formatter threads for write_results and save_results; 0 (the default)
+    // uses one per core
+    void set_output_threads(size_t threads) { m_output_threads = threads; }
+    size_t output_threads() const { return m_output_threads; }
+
+    // Output generation. Prefer save_results or a sink for large result sets:
+    // format_results holds the whole output in memory.
     std::string format_results(const SearchResults& results, OutputFormat format) const;
+    bool write_results(const SearchResults& results, OutputFormat format, OutputSink& sink) const;
+    bool write_results(const SearchResults& results, OutputFormat format, std::ostream& out) const;
+
+    // Formats straight into a file through a FileSink, in memory bounded by its
+    // buffer, compressing on the way when asked (the caller picks the file name).
+    // The file is written as FILENAME.partial and renamed into place once complete.
+    bool save_results(const SearchResults& results, OutputFormat format, const std::string& filename,
+                      std::string& error_message, Compression compression = Compression::None) const;
+
+    // Binary record files (storage/RecordFile.h) for reloading results without
+    // re-parsing; written atomically like save_results
+    bool save_records(const SearchResults& results, const std::string& filename, std::string& error_message) const;
+    SearchResults load_records(const std::string& filename) const;
+
+    // Columnar Parquet export (output/ParquetWriter.h), compressed page by page
+    bool save_parquet(const SearchResults& results, const std::string& filename, std::string& error_message,
+                      Compression compression = Compression::Gzip) const;
+
+    // Embedded SQLite store (storage/ResultStore.h) that accumulates runs,
+    // updating businesses already in it by place ID
+    bool save_to_store(const SearchResults& results, const std::string& filename, std::string& error_message) const;
+    SearchResults query_store(const std::string& filename, const StoreQuery& query) const;
+
+    // Loads a previous run from a binary record file, a JSON or JSON Lines
+    // output file or a whole result store (.db)
+    SearchResults load_results(const std::string& filename) const;
+
+    // Compares current against a previous run (see ChangeDetector); works on spilled results
+    bool diff_results(const SearchResults& previous, const SearchResults& current, ResultDiff& diff,
+                      std::string& error_message) const;
+
+    // Metrics collected since construction or the last reset
+    MetricsSnapshot metrics_snapshot() const { return m_metrics.snapshot(); }
+    void reset_metrics() { m_metrics.reset(); }
 
 private:
     std::string m_api_key;
     std::function<void(const std::string&)> m_status_callback;
+    std::mutex m_status_mutex;
+    mutable MetricsRegistry m_metrics;
+    std::vector<BusinessFields::FieldId> m_output_fields;
+    size_t m_output_threads = 0;
 
     // Helper methods
     void notify_status(const std::string& message);
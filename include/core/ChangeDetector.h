@@ -0,0 +1,61 @@
+#ifndef CHANGE_DETECTOR_H
+#define CHANGE_DETECTOR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "core/Business.h"
+
+// Records that differ between two runs of the same search
+struct ResultDiff {
+    std::vector<Business> added;
+    std::vector<Business> removed;   // As they were in the previous run
+    std::vector<Business> changed;   // As they are in the current run
+    size_t unchanged = 0;
+
+    bool empty() const { return added.empty() && removed.empty() && changed.empty(); }
+};
+
+// Compares a run against a previous one in a single linear pass. The previous
+// records are indexed by identity (place ID, or normalised name and address
+// when the previous output has no place IDs, as with JSON) in hash maps; each
+// current record is then looked up and its fingerprint compared.
+//
+//   ChangeDetector detector(previous);
+//   for (const auto& business : current) detector.add(business);
+//   ResultDiff diff = detector.finish();
+class ChangeDetector {
+public:
+    explicit ChangeDetector(std::vector<Business> previous);
+    ~ChangeDetector();
+
+    // Classifies one record of the current run as added, changed or unchanged
+    void add(const Business& current);
+
+    // Collects the previous records no current record matched as removed.
+    // Call once, after the last add().
+    ResultDiff finish();
+
+    static ResultDiff compare(std::vector<Business> previous, const std::vector<Business>& current);
+
+    // Stable 64-bit content fingerprint (FNV-1a, identical across platforms and
+    // builds). Covers the fields every output format carries; strings are
+    // compared ignoring case and whitespace runs, lists ignoring order, and the
+    // rating to two decimals. Place ID and coordinates are identity, not content.
+    static uint64_t fingerprint(const Business& business);
+
+private:
+    std::vector<Business> m_previous;
+    std::vector<uint64_t> m_previous_fingerprints;
+    std::vector<bool> m_matched;
+    std::unordered_map<uint64_t, size_t> m_by_place_id;
+    std::unordered_map<uint64_t, size_t> m_by_name_address;
+    bool m_name_address_indexed;
+    ResultDiff m_diff;
+
+    static uint64_t place_key(const Business& business);
+    static uint64_t name_address_key(const Business& business);
+};
+
+#endif
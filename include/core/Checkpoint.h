@@ -0,0 +1,60 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include "core/Business.h"
+
+// Append-only journal of batch progress. Every fetched business and every
+// completed job is written as one line as soon as it happens, so a run that
+// dies part way can be resumed without repeating finished work.
+class Checkpoint {
+public:
+    Checkpoint();
+    ~Checkpoint();
+
+    // Loads any existing journal and opens it for appending
+    bool open(const std::string& filename);
+    void close();
+    bool is_open() const { return m_file.is_open(); }
+
+    // Restored state
+    bool is_job_completed(const std::string& job_key) const;
+    bool has_place(const std::string& place_id) const;
+    bool is_complete(const std::string& place_id) const;
+    // Key of the job that fetched a restored place; empty when the journal does not say
+    std::string place_job(const std::string& place_id) const;
+    std::vector<Business> restored_businesses() const;
+    size_t restored_count() const { return m_order.size(); }
+
+    // Journaling (thread-safe). A complete business has no website data left to
+    // fetch; job_key names the batch job that fetched it.
+    void record_business(const Business& business, bool complete, const std::string& job_key = "");
+    void record_job_completed(const std::string& job_key);
+
+    // Error handling
+    std::string last_error() const { return m_last_error; }
+
+private:
+    struct Entry {
+        Business business;
+        bool complete = false;
+        std::string job_key;
+    };
+
+    std::ofstream m_file;
+    mutable std::mutex m_mutex;
+    std::unordered_set<std::string> m_completed_jobs;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::vector<std::string> m_order;
+    std::string m_last_error;
+
+    bool load(const std::string& filename);
+    void append_line(const std::string& line);
+};
+
+#endif
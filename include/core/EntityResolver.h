@@ -0,0 +1,49 @@
+#ifndef ENTITY_RESOLVER_H
+#define ENTITY_RESOLVER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/Business.h"
+
+// Merges records describing the same business that arrived from different
+// queries or sources. Records match when they share a place ID, or at least two
+// of: normalised phone number, website domain and street address (a single
+// shared key is too weak: chain branches share a domain, mall shops an address).
+// Matching uses hash indices and union-find, so it runs in near-linear time.
+class EntityResolver {
+public:
+    EntityResolver();
+    ~EntityResolver();
+
+    // Merges matching records into the earliest one, preserving order.
+    // Returns the number of records merged away.
+    size_t resolve(std::vector<Business>& businesses) const;
+
+    // Merges records at the same address or phone whose names differ only
+    // slightly ("Joe's Coffee" / "Joe’s Coffee House"). Candidate pairs come
+    // from MinHash locality-sensitive hashing of name trigrams and are confirmed
+    // by a bounded edit distance, avoiding an all-pairs comparison.
+    // Returns the number of records merged away.
+    size_t resolve_similar_names(std::vector<Business>& businesses) const;
+
+    // Merges records within max_distance_meters of each other whose names are
+    // within the same edit-distance bound, using a GeoIndex for neighbour lookups.
+    // Records without coordinates are left alone. Returns the merge count.
+    size_t resolve_nearby(std::vector<Business>& businesses, double max_distance_meters) const;
+
+    // Field-by-field merge: empty fields are filled from source, differing
+    // phones/emails become additional ones, and list fields are unioned
+    static void merge_into(Business& target, const Business& source);
+
+    // Normalised match keys (empty when the field is unusable as a key)
+    static std::string normalize_phone(std::string_view phone);
+    static std::string normalize_domain(std::string_view website);
+    static std::string normalize_address(std::string_view address);
+    static std::string normalize_name(std::string_view name);
+
+    // Levenshtein distance, or max_distance + 1 once it is known to exceed max_distance
+    static int bounded_edit_distance(std::string_view a, std::string_view b, int max_distance);
+};
+
+#endif
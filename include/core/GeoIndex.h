@@ -0,0 +1,76 @@
+#ifndef GEO_INDEX_H
+#define GEO_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "core/Business.h"
+
+struct GeoPoint {
+    double latitude = 0.0;
+    double longitude = 0.0;
+};
+
+// Latitude/longitude rectangle; west > east means it crosses the antimeridian
+struct GeoBounds {
+    double south = 0.0;
+    double west = 0.0;
+    double north = 0.0;
+    double east = 0.0;
+};
+
+// In-memory spatial index over businesses with coordinates. Points are bucketed
+// into fixed-size latitude/longitude cells (like geohash cells, but with
+// integer keys) and stored sorted by cell, so a query binary-searches once per
+// row of cells it overlaps and then scans contiguous memory. Queries return
+// indices into the vector passed to build(); businesses without coordinates
+// are never returned.
+class GeoIndex {
+public:
+    // About 1.1 km of latitude: a few dozen businesses per cell in a dense city
+    static constexpr double DEFAULT_CELL_DEGREES = 0.01;
+
+    explicit GeoIndex(double cell_degrees = DEFAULT_CELL_DEGREES);
+    ~GeoIndex();
+
+    void build(const std::vector<Business>& businesses);
+    void clear() { m_entries.clear(); }
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+    // Indices within radius_meters of center (great-circle distance), ascending
+    std::vector<size_t> query_radius(const GeoPoint& center, double radius_meters) const;
+    size_t count_radius(const GeoPoint& center, double radius_meters) const;
+
+    // Indices inside bounds (edges inclusive), ascending
+    std::vector<size_t> query_bounds(const GeoBounds& bounds) const;
+
+    static double distance_meters(const GeoPoint& a, const GeoPoint& b);
+
+private:
+    struct Entry {
+        uint64_t cell;
+        double latitude;
+        double longitude;
+        double cos_latitude;
+        uint32_t record;
+    };
+
+    double m_cell_degrees;
+    int32_t m_column_count;
+    std::vector<Entry> m_entries;  // Sorted by cell, then record
+
+    uint64_t cell_key(int32_t row, int32_t column) const;
+    int32_t row_of(double latitude) const;
+    int32_t column_of(double longitude) const;
+
+    // Calls visit(entry) for every entry in the cells overlapping the rectangle
+    template <typename Visitor>
+    void scan_cells(double south, double west, double north, double east, Visitor&& visit) const;
+
+    template <typename Visitor>
+    void visit_radius(const GeoPoint& center, double radius_meters, Visitor&& visit) const;
+};
+
+#endif
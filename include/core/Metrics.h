@@ -0,0 +1,92 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+// One counter value, e.g. errors{type="timeout"}
+struct CounterSample {
+    std::string name;
+    std::string label;  // Value of the "type" label, empty if unlabelled
+    uint64_t value = 0;
+};
+
+// Latency distribution of one stage, optionally per host
+struct HistogramSample {
+    std::string name;
+    std::string label;  // Value of the "host" label, empty for per-stage totals
+    std::vector<double> bucket_bounds_ms;  // Upper bounds, last bucket is +Inf
+    std::vector<uint64_t> bucket_counts;   // bucket_bounds_ms.size() + 1 entries
+    uint64_t count = 0;
+    double sum_ms = 0.0;
+    double max_ms = 0.0;
+
+    double mean_ms() const { return count > 0 ? sum_ms / count : 0.0; }
+    double percentile_ms(double percentile) const;
+};
+
+// Point-in-time copy of every metric
+struct MetricsSnapshot {
+    std::vector<CounterSample> counters;
+    std::vector<HistogramSample> histograms;
+
+    uint64_t counter(const std::string& name, const std::string& label = "") const;
+    const HistogramSample* histogram(const std::string& name, const std::string& label = "") const;
+
+    // Export
+    std::string to_json() const;
+    std::string to_prometheus() const;
+};
+
+// Thread-safe store of counters and latency histograms
+class MetricsRegistry {
+public:
+    MetricsRegistry();
+    ~MetricsRegistry();
+
+    void increment(const std::string& name, const std::string& label = "", uint64_t amount = 1);
+    void record_latency(const std::string& stage, double milliseconds, const std::string& host = "");
+
+    MetricsSnapshot snapshot() const;
+    void reset();
+
+private:
+    struct Histogram {
+        std::vector<uint64_t> bucket_counts;
+        uint64_t count = 0;
+        double sum_ms = 0.0;
+        double max_ms = 0.0;
+    };
+
+    using Key = std::pair<std::string, std::string>;
+
+    mutable std::mutex m_mutex;
+    std::map<Key, uint64_t> m_counters;
+    std::map<Key, Histogram> m_histograms;
+
+    void observe(Histogram& histogram, double milliseconds);
+};
+
+// Records the lifetime of a scope as one latency sample (no-op without a registry)
+class ScopedLatency {
+public:
+    ScopedLatency(MetricsRegistry* registry, const std::string& stage, const std::string& host = "");
+    ~ScopedLatency();
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    void set_host(const std::string& host) { m_host = host; }
+
+private:
+    MetricsRegistry* m_registry;
+    std::string m_stage;
+    std::string m_host;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef RESULT_SPILL_H
+#define RESULT_SPILL_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include "core/Business.h"
+
+// Holds search results within a memory budget. Records are buffered in memory
+// and appended to a spill file whenever the buffer would exceed the budget;
+// reading streams them back one at a time in the order they were added.
+// If the file cannot be created or a write fails (disk full, I/O error), the
+// spill sets last_error() and keeps every further record in memory, so no
+// result is lost; records already written stay readable.
+class ResultSpill {
+public:
+    ResultSpill(const std::string& filename, size_t memory_budget_bytes);
+    ~ResultSpill();
+
+    ResultSpill(const ResultSpill&) = delete;
+    ResultSpill& operator=(const ResultSpill&) = delete;
+
+    void append(Business business);
+    bool for_each(const std::function<void(const Business&)>& callback);
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    size_t buffered_bytes() const { return m_buffered_bytes; }
+    size_t memory_budget() const { return m_memory_budget; }
+
+    // Approximate heap footprint of a record, as counted against the budget
+    static size_t estimated_size(const Business& business);
+    std::string filename() const { return m_filename; }
+
+    // Error handling
+    std::string last_error() const { return m_last_error; }
+
+private:
+    std::string m_filename;
+    size_t m_memory_budget;
+    std::ofstream m_file;
+    std::vector<Business> m_buffer;
+    size_t m_buffered_bytes;
+    size_t m_count;
+    size_t m_spilled_count;   // Complete records in the file
+    std::string m_last_error;
+
+    void flush_buffer();
+};
+
+#endif
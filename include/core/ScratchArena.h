@@ -0,0 +1,32 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+
+// Bump allocator for the short-lived strings produced while scraping: URLs,
+// response bodies, regex matches and phone digit buffers. Allocations come
+// from one preallocated block (then a few geometrically growing ones) and are
+// all freed at once by release(), so a search costs a handful of heap
+// allocations no matter how many intermediate strings it builds.
+// Not thread-safe: each search or worker owns its own arena.
+class ScratchArena {
+public:
+    explicit ScratchArena(size_t initial_bytes = 64 * 1024);
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &m_resource; }
+
+    // Frees everything allocated since the last release; the initial block is kept
+    void release() { m_resource.release(); }
+
+private:
+    std::unique_ptr<char[]> m_initial_block;
+    std::pmr::monotonic_buffer_resource m_resource;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <cstdint>
+
+// Timeline tracing exported as Chrome trace-event JSON (chrome://tracing, Perfetto).
+// Spans are only recorded when built with BUSINESS_SCRAPER_TRACING; otherwise
+// TRACE_SCOPE expands to nothing and the Tracer calls are inert.
+class Tracer {
+public:
+    static bool is_compiled_in();
+
+    // Recording starts disabled so spans cost nothing until a trace is requested
+    static void start();
+    static void stop();
+    static bool is_recording();
+
+    static bool write_chrome_trace(const std::string& filename);
+    static std::string last_error();
+
+    // Called by TraceSpan; name must be a string literal
+    static void record(const char* name, int64_t start_us, int64_t duration_us);
+    static int64_t now_us();
+};
+
+#ifdef BUSINESS_SCRAPER_TRACING
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : m_name(Tracer::is_recording() ? name : nullptr)
+        , m_start_us(m_name ? Tracer::now_us() : 0)
+    {}
+
+    ~TraceSpan() {
+        if (m_name) {
+            Tracer::record(m_name, m_start_us, Tracer::now_us() - m_start_us);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_start_us;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceSpan TRACE_CONCAT(trace_span_, __LINE__)(name)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+
+#endif
+
+#endif
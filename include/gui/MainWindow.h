@@ -32,6 +32,8 @@ private slots:
     void showAboutDialog();
     void showLicenseDialog();
     void exportResults();
+    void openResults();
+    void searchStore();
     void openConfiguration();
 
 private:
@@ -40,6 +42,7 @@ private:
     void setupStatusBar();
     void setupConnections();
     void updateWindowTitle(const QString& subtitle = QString());
+    void showLoadedResults(SearchResults* results);
 
     // UI Components
     SearchWidget* m_searchWidget;
@@ -54,6 +57,7 @@ private:
     // Business logic
     BusinessScraperEngine* m_engine;
     SearchResults* m_lastResults;
+    QString m_storePath;  // Result store every search is added to
 
     // State
     bool m_searchInProgress;
@@ -61,7 +61,7 @@ private:
     // Data
     const SearchResults* m_currentResults;
 
-    // Table columns
+    // Table columns, in the order of TableFields in ResultsWidget.cpp
     enum Columns {
         COL_NAME = 0,
         COL_ADDRESS,
@@ -12,6 +12,8 @@
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QGroupBox>
 #include <QtWidgets/QLabel>
+#include <QtWidgets/QToolButton>
+#include <QtWidgets/QMenu>
 
 #include "core/BusinessScraperEngine.h"
 
@@ -25,6 +27,9 @@ public:
     // Get current search options
     SearchOptions getSearchOptions() const;
     OutputFormat getOutputFormat() const;
+    Compression getCompression() const;
+    // Fields to export, in output order; empty when every field is selected
+    std::vector<BusinessFields::FieldId> getOutputFields() const;
 
     // UI state management
     void setSearchEnabled(bool enabled);
@@ -46,6 +51,8 @@ private:
     void setupUI();
     void setupConnections();
     void updateSearchButton();
+    void updateFieldsButton();
+    size_t selectedFieldCount() const;
 
     // Search parameters
     QLineEdit* m_keywordEdit;
@@ -54,7 +61,13 @@ private:
 
     // Options
     QCheckBox* m_webScrapingCheckBox;
+    QCheckBox* m_mergeDuplicatesCheckBox;
+    QCheckBox* m_mergeSimilarNamesCheckBox;
+    QSpinBox* m_mergeNearbySpinBox;
     QComboBox* m_formatComboBox;
+    QComboBox* m_compressionComboBox;
+    QToolButton* m_fieldsButton;
+    QMenu* m_fieldsMenu;
 
     // Actions
     QPushButton* m_searchButton;
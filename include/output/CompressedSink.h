@@ -0,0 +1,57 @@
+#ifndef COMPRESSED_SINK_H
+#define COMPRESSED_SINK_H
+
+#include <memory>
+#include <string>
+#include "output/OutputSink.h"
+
+enum class Compression {
+    None,
+    Gzip,
+    Zstd    // Only in builds with BUSINESS_SCRAPER_ZSTD (libzstd found)
+};
+
+// File name suffix for the codec ("gz", "zst"), or "" for None
+const char* compression_extension(Compression compression);
+
+// Whether this build can write the codec
+bool compression_supported(Compression compression);
+
+class CompressionCodec;
+
+// Compresses everything written to it into another sink, a buffer at a time,
+// so output is compressed as it is produced instead of in a second pass.
+// finish() must be called once all data is written: it flushes the codec and
+// writes the end of the stream (the gzip trailer or the last zstd frame).
+//
+// Errors from the codec or the target sink are sticky, as for any sink.
+class CompressedSink : public OutputSink {
+public:
+    // level 0 picks 3 for both codecs; for gzip that is about twice as fast
+    // as zlib's default 6 for roughly 10% larger exports
+    CompressedSink(OutputSink& target, Compression compression, int level = 0,
+                   size_t buffer_size = DEFAULT_BUFFER_SIZE);
+    ~CompressedSink() override;
+
+    // Compresses the remaining input and ends the stream; false on any error
+    bool finish();
+
+    // Uncompressed and compressed byte counts so far
+    size_t bytes_in() const { return m_bytes_in; }
+    size_t bytes_out() const { return m_bytes_out; }
+
+protected:
+    bool write_through(const char* data, size_t size) override;
+
+private:
+    OutputSink& m_target;
+    std::unique_ptr<CompressionCodec> m_codec;
+    std::unique_ptr<char[]> m_out;
+    size_t m_bytes_in;
+    size_t m_bytes_out;
+    bool m_finished;
+
+    bool compress(const char* data, size_t size, bool end);
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef ESCAPE_SCAN_H
+#define ESCAPE_SCAN_H
+
+#include <cstddef>
+
+// Vectorised searches for the bytes each output format may need to escape.
+// They test 32 bytes per step with AVX2, 16 with SSE2 (always available on
+// x86-64), or one at a time elsewhere, so clean text is skipped at close to
+// memcpy speed. The AVX2 path is used when the build targets it
+// (-mavx2 or -march=native with GCC/Clang, /arch:AVX2 with MSVC).
+//
+// Each returns the offset of the first candidate byte, or size if there is
+// none. JSON candidates include every control character; the caller decides
+// which of those it actually escapes.
+namespace EscapeScan {
+    size_t find_json(const char* data, size_t size);  // " \ and bytes below 0x20
+    size_t find_xml(const char* data, size_t size);   // < > & " '
+    size_t find_csv(const char* data, size_t size);   // , " and newline: the field must be quoted
+    size_t find_quote(const char* data, size_t size); // "
+
+    // "avx2", "sse2" or "scalar"
+    const char* implementation();
+}
+
+#endif
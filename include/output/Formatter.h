@@ -2,18 +2,25 @@
 #define FORMATTER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include "core/Business.h"
+#include "core/BusinessFields.h"
+#include "output/OutputSink.h"
 
 enum class OutputFormat {
     CSV,
     JSON,
     YAML,
-    XML
+    XML,
+    JSONL   // JSON Lines: one compact object per line, no enclosing document
 };
 
 class Formatter {
 public:
+    // Records per unit of parallel work; inputs under two chunks are formatted serially
+    static constexpr size_t CHUNK_RECORDS = 2048;
+
     Formatter();
     explicit Formatter(OutputFormat format);
     ~Formatter();
@@ -22,23 +29,54 @@ public:
     OutputFormat format() const { return m_format; }
     void set_format(OutputFormat format) { m_format = format; }
 
+    // Formatting threads for write_records; 0 (the default) uses one per core
+    size_t threads() const { return m_threads; }
+    void set_threads(size_t threads) { m_threads = threads; }
+    size_t effective_threads() const;
+
+    // Fields to write, in this order; empty (the default) writes every field.
+    // Unselected fields are skipped without reading them from the records.
+    const std::vector<BusinessFields::FieldId>& fields() const { return m_fields; }
+    void set_fields(std::vector<BusinessFields::FieldId> fields) { m_fields = std::move(fields); }
+
     // Main functionality
     std::string format_businesses(const std::vector<Business>& businesses) const;
 
+    // Streaming output: begin, one write_record per record (index counts from
+    // 0), then end. Produces the same bytes as format_businesses without
+    // holding more than the sink's buffer in memory.
+    void begin(OutputSink& sink) const;
+    void write_record(OutputSink& sink, const Business& business, size_t index) const;
+    void end(OutputSink& sink, size_t record_count) const;
+
+    // Same bytes as write_record over every record, numbered from first_index.
+    // Large inputs are cut into chunks formatted concurrently into per-thread
+    // buffers, which are written to the sink in order as each one completes.
+    void write_records(OutputSink& sink, const std::vector<Business>& businesses, size_t first_index = 0) const;
+
 private:
     OutputFormat m_format;
+    size_t m_threads;
+    std::vector<BusinessFields::FieldId> m_fields;
+
+    // Calls visit(BusinessFields::Field<Id>()) for each selected field, in order
+    template <typename Visitor>
+    void for_each_selected(Visitor&& visit) const;
 
     // Format-specific methods
-    std::string format_as_csv(const std::vector<Business>& businesses) const;
-    std::string format_as_json(const std::vector<Business>& businesses) const;
-    std::string format_as_yaml(const std::vector<Business>& businesses) const;
-    std::string format_as_xml(const std::vector<Business>& businesses) const;
-
-    // Helper methods
-    std::string escape_csv_field(const std::string& field) const;
-    std::string escape_json_string(const std::string& str) const;
-    std::string escape_xml_string(const std::string& str) const;
-    std::string vector_to_string(const std::vector<std::string>& vec, const std::string& delimiter = ", ") const;
+    void write_csv_record(OutputSink& sink, const Business& business) const;
+    void write_json_record(OutputSink& sink, const Business& business) const;
+    void write_yaml_record(OutputSink& sink, const Business& business) const;
+    void write_xml_record(OutputSink& sink, const Business& business) const;
+    void write_jsonl_record(OutputSink& sink, const Business& business) const;
+
+    // Helper methods; escaping writes straight into the sink
+    void write_csv_header(OutputSink& sink) const;
+    void write_csv_field(OutputSink& sink, std::string_view field) const;
+    void write_csv_list(OutputSink& sink, const std::vector<std::string>& values) const;
+    void write_json_list(OutputSink& sink, const std::vector<std::string>& values, std::string_view separator = ", ") const;
+    void write_json_string(OutputSink& sink, std::string_view str) const;
+    void write_xml_string(OutputSink& sink, std::string_view str) const;
 };
 
 #endif
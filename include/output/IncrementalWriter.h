@@ -0,0 +1,65 @@
+#ifndef INCREMENTAL_WRITER_H
+#define INCREMENTAL_WRITER_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "core/Business.h"
+#include "output/CompressedSink.h"
+#include "output/Formatter.h"
+#include "output/OutputSink.h"
+
+// Writes formatted records to their output file while a run is still
+// producing them, instead of formatting everything once the run is over.
+//
+// Records go to FILENAME.partial (see FileSink::open_atomic), which is handed
+// to the OS every FLUSH_RECORDS records or FLUSH_INTERVAL, whichever comes
+// first. If the process dies, the .partial file holds every record up to the
+// last flush; JSON Lines and CSV lines in it are complete and usable as they
+// are. finish() writes the closing JSON/XML framing, syncs the file to disk
+// and renames it to FILENAME, so FILENAME only ever appears complete. With
+// compression, the .partial file lags by what the codec still holds.
+//
+// write() may be called from several threads.
+class IncrementalWriter {
+public:
+    static constexpr size_t FLUSH_RECORDS = 1000;
+    static constexpr std::chrono::seconds FLUSH_INTERVAL{2};
+
+    IncrementalWriter();
+    ~IncrementalWriter();   // Without finish(), the .partial file is left as it is
+
+    IncrementalWriter(const IncrementalWriter&) = delete;
+    IncrementalWriter& operator=(const IncrementalWriter&) = delete;
+
+    // The formatter is copied, with its format and field selection
+    bool open(const std::string& filename, const Formatter& formatter,
+              Compression compression = Compression::None);
+    bool write(const Business& business);
+    bool finish();
+
+    // Closes and deletes the .partial file, for runs that produced nothing
+    void discard();
+
+    size_t record_count() const;
+    std::string partial_filename() const;
+
+    // Error handling
+    std::string last_error() const;
+
+private:
+    mutable std::mutex m_mutex;
+    Formatter m_formatter;
+    FileSink m_file;
+    std::unique_ptr<CompressedSink> m_compressed;
+    OutputSink* m_sink;
+    size_t m_record_count;
+    size_t m_unflushed;
+    std::chrono::steady_clock::time_point m_last_flush;
+    std::string m_last_error;
+
+    bool flush_locked();
+};
+
+#endif
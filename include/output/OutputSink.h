@@ -0,0 +1,129 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <memory>
+#include <cstring>
+#include <cstddef>
+
+// Buffered byte destination for formatted output. Writes are copied into a
+// fixed buffer that is handed to the destination only when it fills up or on
+// flush(), so memory stays at the buffer size however large the output grows.
+//
+// Errors are sticky, like an ostream's failbit: after the first failure
+// further writes are dropped, and ok()/flush() report it.
+class OutputSink {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+    explicit OutputSink(size_t buffer_size = DEFAULT_BUFFER_SIZE);
+    virtual ~OutputSink();
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    void write(const char* data, size_t size) {
+        if (size <= m_capacity - m_size) {
+            std::memcpy(m_buffer.get() + m_size, data, size);
+            m_size += size;
+        } else {
+            write_slow(data, size);
+        }
+    }
+    void write(std::string_view text) { write(text.data(), text.size()); }
+    void put(char c) {
+        if (m_size == m_capacity) drain();
+        m_buffer[m_size++] = c;
+    }
+
+    // Hands the buffered bytes to the destination; false if any write failed
+    bool flush();
+    bool ok() const { return m_last_error.empty(); }
+
+    // Error handling
+    std::string last_error() const { return m_last_error; }
+
+protected:
+    // Delivers bytes to the destination; returns false after calling set_error
+    virtual bool write_through(const char* data, size_t size) = 0;
+    void set_error(const std::string& error);
+
+private:
+    std::unique_ptr<char[]> m_buffer;
+    size_t m_capacity;
+    size_t m_size;
+    std::string m_last_error;
+
+    void drain();
+    void write_slow(const char* data, size_t size);
+};
+
+// Appends to a string; for callers that need the output in memory
+class StringSink : public OutputSink {
+public:
+    explicit StringSink(std::string& target, size_t buffer_size = 64 * 1024);
+    ~StringSink() override;
+
+protected:
+    bool write_through(const char* data, size_t size) override;
+
+private:
+    std::string& m_target;
+};
+
+// Adapter for an existing stream such as std::cout
+class StreamSink : public OutputSink {
+public:
+    explicit StreamSink(std::ostream& out, size_t buffer_size = 64 * 1024);
+    ~StreamSink() override;
+
+protected:
+    bool write_through(const char* data, size_t size) override;
+
+private:
+    std::ostream& m_out;
+};
+
+// Writes straight to a file descriptor, bypassing iostreams. The file is
+// created (with missing parent directories) or truncated by open().
+//
+// open_atomic() writes to FILENAME.partial instead, and commit() makes it
+// durable and renames it over FILENAME. Readers of FILENAME then see either
+// the previous file or the complete new one, never a half-written one; after
+// a crash, or a close() without commit(), the .partial file keeps whatever
+// had been written.
+class FileSink : public OutputSink {
+public:
+    static constexpr const char* PARTIAL_SUFFIX = ".partial";
+
+    explicit FileSink(size_t buffer_size = DEFAULT_BUFFER_SIZE);
+    ~FileSink() override;
+
+    bool open(const std::string& filename);
+    bool open_atomic(const std::string& filename);
+
+    // Flushes and asks the OS to put the bytes on disk (fsync)
+    bool sync();
+
+    // Flushes and closes; false if any write or the close failed
+    bool close();
+    // Atomic files only: sync, close and rename into place; false (leaving
+    // the .partial file) if any step failed
+    bool commit();
+    bool is_open() const { return m_fd >= 0; }
+
+    // The file being written: FILENAME, or FILENAME.partial until commit()
+    const std::string& path() const { return m_path; }
+
+protected:
+    bool write_through(const char* data, size_t size) override;
+
+private:
+    int m_fd;
+    std::string m_filename;
+    std::string m_path;
+};
+
+#endif
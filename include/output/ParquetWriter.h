@@ -0,0 +1,90 @@
+#ifndef PARQUET_WRITER_H
+#define PARQUET_WRITER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "core/Business.h"
+#include "output/CompressedSink.h"
+#include "output/OutputSink.h"
+
+// Columnar export in Apache Parquet format, written without Arrow.
+//
+// Each Business field becomes a typed column: strings as UTF-8 BYTE_ARRAY,
+// rating as DOUBLE, total_ratings as INT32, coordinates as nullable DOUBLE,
+// fetched_at as a nullable millisecond TIMESTAMP and the contact lists as
+// LIST<string>. Rows are buffered column by column and written out as a row
+// group whenever ROW_GROUP_ROWS rows or ROW_GROUP_BYTES bytes accumulate, so
+// memory stays bounded; the footer with the schema and every column chunk's
+// offset is written by close(). Pages are PLAIN-encoded and compressed with
+// gzip or zstd, so readers can load any subset of columns. The file is built
+// as FILENAME.partial and only renamed to FILENAME once its footer is written.
+namespace ParquetFile {
+    const char* const EXTENSION = "parquet";
+}
+
+class ParquetWriter {
+public:
+    static constexpr size_t ROW_GROUP_ROWS = 32768;
+    static constexpr size_t ROW_GROUP_BYTES = 64 << 20;
+
+    ParquetWriter();
+    ~ParquetWriter();
+
+    ParquetWriter(const ParquetWriter&) = delete;
+    ParquetWriter& operator=(const ParquetWriter&) = delete;
+
+    // compression picks the page codec; None writes uncompressed pages
+    bool open(const std::string& filename, Compression compression = Compression::Gzip);
+    bool write(const Business& business);
+    bool close();
+
+    size_t record_count() const { return m_record_count; }
+
+    // Error handling
+    std::string last_error() const { return m_last_error; }
+
+private:
+    // One leaf column's values and levels for the current row group
+    struct ColumnBuffer {
+        std::string values;                // PLAIN-encoded non-null values
+        std::vector<uint8_t> definition;   // Only for nullable and list columns
+        std::vector<uint8_t> repetition;   // Only for list columns
+        size_t level_count = 0;            // Values including nulls and empty lists
+    };
+
+    // Where a written column chunk landed, for the footer
+    struct ChunkInfo {
+        int64_t offset;
+        int64_t level_count;
+        int64_t uncompressed_size;
+        int64_t compressed_size;
+    };
+
+    struct RowGroupInfo {
+        std::vector<ChunkInfo> chunks;
+        int64_t row_count;
+        int64_t uncompressed_size;
+        int64_t compressed_size;
+    };
+
+    FileSink m_file;
+    Compression m_compression;
+    std::vector<ColumnBuffer> m_columns;
+    std::vector<RowGroupInfo> m_row_groups;
+    size_t m_buffered_rows;
+    size_t m_buffered_bytes;
+    size_t m_record_count;
+    uint64_t m_position;
+    std::string m_last_error;
+
+    void append_string(size_t column, std::string_view value);
+    void append_list(size_t column, const std::vector<std::string>& values);
+    bool write_bytes(std::string_view bytes);
+    bool flush_row_group();
+    bool write_footer();
+};
+
+#endif
@@ -2,9 +2,14 @@
 #define MAPSCRAPER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <functional>
+#include <memory_resource>
 #include "core/Business.h"
 
+class MetricsRegistry;
+
 class MapScraper {
 private:
     std::string m_api_key;
@@ -12,13 +17,19 @@ private:
     std::string m_location;
     int m_max_radius;
     int m_max_results;
+    std::function<bool(const std::string&)> m_place_filter;
+    std::function<void(const std::string&)> m_place_release;
+    std::function<bool(const std::string&)> m_place_known;
+    std::function<void(const Business&)> m_business_callback;
+    MetricsRegistry* m_metrics;
 
-    // Helper methods
-    std::string build_search_url() const;
-    std::string make_http_request(const std::string& url) const;
-    std::vector<Business> parse_response(const std::string& json_response) const;
-    std::vector<Business> parse_response_with_pagination(const std::string& json_response, std::string& next_page_token, int& current_count) const;
-    Business parse_business_details(const std::string& place_id) const;
+    // Helper methods; intermediate strings are allocated from the search's scratch arena
+    std::pmr::string build_search_url(std::pmr::memory_resource* scratch) const;
+    std::pmr::string make_http_request(const std::pmr::string& url, std::pmr::memory_resource* scratch) const;
+    std::vector<Business> parse_response(std::string_view json_response, std::pmr::memory_resource* scratch) const;
+    std::vector<Business> parse_response_with_pagination(std::string_view json_response, std::string& next_page_token, int& current_count,
+                                                         std::pmr::memory_resource* scratch) const;
+    Business parse_business_details(const std::string& place_id, std::pmr::memory_resource* scratch) const;
 
 public:
     MapScraper();
@@ -47,8 +58,34 @@ public:
     int max_results() const { return m_max_results; }
     void set_max_results(int results) { m_max_results = results; }
 
+    // Place filter: return false to skip fetching details for a place ID
+    // (used to share deduplication across several scrapers)
+    void set_place_filter(std::function<bool(const std::string&)> filter) { m_place_filter = std::move(filter); }
+
+    // Place release: invoked for a place ID the filter accepted but whose details
+    // could not be fetched, so the filter can let a later request try it again
+    void set_place_release(std::function<void(const std::string&)> release) { m_place_release = std::move(release); }
+
+    // Known place: return true for a place ID this search already fetched (for
+    // example in an interrupted run). It counts toward max_results as it did
+    // then, but is neither fetched again nor returned; checked before the filter
+    void set_place_known(std::function<bool(const std::string&)> known) { m_place_known = std::move(known); }
+
+    // Business callback: invoked as soon as each business's details are fetched
+    void set_business_callback(std::function<void(const Business&)> callback) { m_business_callback = std::move(callback); }
+
+    // Metrics: record request counts, bytes, errors and latencies (may be null)
+    void set_metrics(MetricsRegistry* metrics) { m_metrics = metrics; }
+
     // Main functionality
     std::vector<Business> search_businesses();
+
+    // Fetches details for one known place ID (used to refresh a stored record);
+    // the result has an empty name if the fetch failed
+    Business fetch_business(const std::string& place_id) const;
+
+    // Initialize libcurl once before scrapers are used from multiple threads
+    static void initialize_http();
 };
 
 #endif
\ No newline at end of file
@@ -2,9 +2,14 @@
 #define WEBSCRAPER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <regex>
+#include <memory_resource>
 #include "core/Business.h"
+#include "core/ScratchArena.h"
+
+class MetricsRegistry;
 
 class WebScraper {
 public:
@@ -13,6 +18,7 @@ public:
 
     // Main functionality
     void enhance_businesses(std::vector<Business>& businesses);
+    bool enhance_business(Business& business);
 
     // Configuration
     void set_timeout(int timeout_seconds) { m_timeout = timeout_seconds; }
@@ -21,18 +27,25 @@ public:
     void set_max_retries(int retries) { m_max_retries = retries; }
     int max_retries() const { return m_max_retries; }
 
+    // Metrics: record request counts, bytes, errors and latencies (may be null)
+    void set_metrics(MetricsRegistry* metrics) { m_metrics = metrics; }
+
 private:
     int m_timeout;
     int m_max_retries;
+    MetricsRegistry* m_metrics;
+
+    // Scratch memory for page bodies and matches, reset after each business
+    ScratchArena m_scratch;
 
     // Core scraping methods
-    std::string fetch_website_content(const std::string& url) const;
-    void extract_contact_info(Business& business, const std::string& html_content) const;
+    std::pmr::string fetch_website_content(const std::string& url, std::pmr::memory_resource* scratch) const;
+    void extract_contact_info(Business& business, std::string_view html_content, std::pmr::memory_resource* scratch) const;
 
     // Extraction methods
-    std::vector<std::string> extract_emails(const std::string& content) const;
-    std::vector<std::string> extract_phone_numbers(const std::string& content) const;
-    std::vector<std::string> extract_social_links(const std::string& content) const;
+    std::pmr::vector<std::pmr::string> extract_emails(std::string_view content, std::pmr::memory_resource* scratch) const;
+    std::pmr::vector<std::pmr::string> extract_phone_numbers(std::string_view content, std::pmr::memory_resource* scratch) const;
+    std::pmr::vector<std::pmr::string> extract_social_links(std::string_view content, std::pmr::memory_resource* scratch) const;
 
     // Regex patterns
     std::regex m_email_regex;
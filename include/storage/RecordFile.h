@@ -0,0 +1,214 @@
+#ifndef RECORD_FILE_H
+#define RECORD_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include "core/Business.h"
+#include "output/OutputSink.h"
+
+// Versioned binary file of Business records.
+//
+// Layout (all integers little-endian):
+//   header   magic "BSRF", uint16 version, uint16 reserved, uint32 field count
+//   schema   per field: uint8 type, uint16 name length, name bytes
+//   records  per record: uint32 payload length, then each field in schema order
+//            (string: uint32 length + bytes; double: 8 bytes IEEE 754; int32: 4 bytes;
+//             string list: uint32 count + strings; string ref: uint32 string table
+//             id; string ref list: uint32 count + ids)
+//   strings  per table string: uint32 length + bytes
+//   strings index  uint64 offset of every table string
+//   index    uint64 offset of every record
+//   trailer  uint64 strings index offset, uint64 string count,
+//            uint64 index offset, uint64 record count, magic "BSRF"
+//
+// The schema makes files self-describing: readers skip fields they do not know
+// and leave fields missing from older files empty. Version 1 files have no
+// string table and a trailer of just the index offset, record count and magic.
+//
+// Fields whose values repeat across records (chain names, shared emails and
+// websites, social links) are string refs into the table, so each distinct
+// value is stored once. Place IDs, addresses and phone numbers are nearly
+// always unique and stay inline: the writer keeps every distinct table string
+// in memory until close(), so only repeating fields are worth interning.
+namespace RecordFile {
+    constexpr uint16_t VERSION = 2;
+    const char* const EXTENSION = "bsr";
+}
+
+// The string table of a mapped file
+class RecordStringTable {
+public:
+    size_t size() const { return m_count; }
+
+    // The string with this id; the id must have passed contains()
+    std::string_view operator[](uint32_t id) const;
+
+    // Whether id names a string lying wholly inside the table
+    bool contains(uint32_t id) const;
+
+private:
+    friend class RecordFileReader;
+
+    const char* m_data = nullptr;    // Start of the mapped file; offsets are absolute
+    const char* m_index = nullptr;   // Also where the strings end
+    size_t m_count = 0;
+};
+
+// Read-only view of a string list field inside a mapped record; items are
+// inline strings, or string table ids when the list has a table
+class RecordStringList {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const char* position, uint32_t remaining, const RecordStringTable* table)
+            : m_position(position), m_remaining(remaining), m_table(table) {}
+        std::string_view operator*() const;
+        const_iterator& operator++();
+        bool operator==(const const_iterator& other) const { return m_remaining == other.m_remaining; }
+        bool operator!=(const const_iterator& other) const { return m_remaining != other.m_remaining; }
+
+    private:
+        const char* m_position;
+        uint32_t m_remaining;
+        const RecordStringTable* m_table;
+    };
+
+    RecordStringList() : m_data(nullptr), m_count(0), m_table(nullptr) {}
+    RecordStringList(const char* data, uint32_t count, const RecordStringTable* table = nullptr)
+        : m_data(data), m_count(count), m_table(table) {}
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    const_iterator begin() const { return const_iterator(m_data, m_count, m_table); }
+    const_iterator end() const { return const_iterator(nullptr, 0, nullptr); }
+
+    std::vector<std::string> to_vector() const;
+
+private:
+    const char* m_data;
+    uint32_t m_count;
+    const RecordStringTable* m_table;
+};
+
+// Zero-copy view of one record; valid while its reader stays open
+class RecordView {
+public:
+    std::string_view place_id() const { return m_strings[PLACE_ID]; }
+    std::string_view name() const { return m_strings[NAME]; }
+    std::string_view address() const { return m_strings[ADDRESS]; }
+    std::string_view phone_number() const { return m_strings[PHONE]; }
+    std::string_view email() const { return m_strings[EMAIL]; }
+    std::string_view website() const { return m_strings[WEBSITE]; }
+    double rating() const { return m_doubles[RATING]; }
+    int total_ratings() const { return m_total_ratings; }
+    double latitude() const { return m_doubles[LATITUDE]; }
+    double longitude() const { return m_doubles[LONGITUDE]; }
+    int64_t fetched_at() const;
+    const RecordStringList& additional_numbers() const { return m_lists[NUMBERS]; }
+    const RecordStringList& additional_emails() const { return m_lists[EMAILS]; }
+    const RecordStringList& social_media_links() const { return m_lists[SOCIAL]; }
+
+    Business to_business() const;
+
+private:
+    friend class RecordFileReader;
+
+    enum StringField { PLACE_ID = 0, NAME, ADDRESS, PHONE, EMAIL, WEBSITE, STRING_FIELD_COUNT };
+    enum ListField { NUMBERS = 0, EMAILS, SOCIAL, LIST_FIELD_COUNT };
+    enum DoubleField { RATING = 0, LATITUDE, LONGITUDE, FETCHED_AT, DOUBLE_FIELD_COUNT };
+
+    std::string_view m_strings[STRING_FIELD_COUNT];
+    RecordStringList m_lists[LIST_FIELD_COUNT];
+    double m_doubles[DOUBLE_FIELD_COUNT] = {0.0, std::numeric_limits<double>::quiet_NaN(),
+                                             std::numeric_limits<double>::quiet_NaN(), 0.0};  // Coordinates stay NaN in files without them
+    int m_total_ratings = 0;
+};
+
+// Streams records to FILENAME.partial; close() writes the string table, index
+// and trailer and only then renames the file over FILENAME, so a crash or a
+// failed write never replaces an existing file. A writer destroyed without
+// close() leaves FILENAME untouched.
+class RecordFileWriter {
+public:
+    RecordFileWriter();
+    ~RecordFileWriter();
+
+    RecordFileWriter(const RecordFileWriter&) = delete;
+    RecordFileWriter& operator=(const RecordFileWriter&) = delete;
+
+    bool open(const std::string& filename);
+    bool write(const Business& business);
+    bool close();
+
+    size_t record_count() const { return m_offsets.size(); }
+
+    // Error handling
+    std::string last_error() const { return m_last_error; }
+
+private:
+    FileSink m_file;
+    std::string m_record;     // Reused encoding buffer
+    std::vector<uint64_t> m_offsets;
+    std::unordered_map<std::string, uint32_t> m_string_ids;
+    std::vector<const std::string*> m_strings;   // Table strings by id (keys of m_string_ids)
+    uint64_t m_position;
+    std::string m_last_error;
+
+    void put_string_ref(const std::string& value);
+    void put_string_refs(const std::vector<std::string>& values);
+};
+
+// Memory-maps a record file. Opening validates only the header, schema and
+// trailer, so it takes constant time regardless of the record count.
+class RecordFileReader {
+public:
+    RecordFileReader();
+    ~RecordFileReader();
+
+    RecordFileReader(const RecordFileReader&) = delete;
+    RecordFileReader& operator=(const RecordFileReader&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+    bool is_open() const { return m_data != nullptr; }
+
+    size_t size() const { return m_record_count; }
+    uint16_t version() const { return m_version; }
+
+    // Decodes record 'index' into 'view'; false if the record is malformed
+    bool read(size_t index, RecordView& view) const;
+
+    // Error handling
+    std::string last_error() const { return m_last_error; }
+
+private:
+    struct SchemaField {
+        uint8_t type;
+        int slot;  // Target field in RecordView, or -1 to skip
+    };
+
+    const char* m_data;
+    size_t m_size;
+    const char* m_index;
+    size_t m_record_count;
+    uint16_t m_version;
+    RecordStringTable m_strings;
+    std::vector<SchemaField> m_schema;
+    mutable std::string m_last_error;
+
+#ifdef _WIN32
+    void* m_file_handle;
+    void* m_mapping_handle;
+#endif
+
+    bool map_file(const std::string& filename);
+    void unmap_file();
+    bool parse_layout();
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "core/Business.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace ResultStoreFile {
+    const char* const EXTENSION = "db";
+}
+
+// Filters for ResultStore::query; empty fields match everything and the
+// fields given are combined with AND. Values are normalised the same way as
+// for entity resolution, so "(555) 123-4567" finds "+1 555-123-4567".
+struct StoreQuery {
+    std::string name;    // Name prefix, ignoring case, punctuation and "the"/"inc"/...
+    std::string phone;   // Any phone format
+    std::string domain;  // Website or bare domain; "www." and the path are ignored
+    size_t limit = 0;    // 0 returns every match
+};
+
+// Embedded SQLite database of businesses that accumulates results across runs.
+//
+// Records are upserted by place ID (records without one, as loaded from JSON,
+// by normalised name and address). A later fetch replaces the stored record,
+// except that website-derived fields it lacks keep their stored values, so a
+// run without web scraping does not erase emails found by an earlier one.
+// Normalised name, phone and domain columns are indexed for query().
+//
+// Writes go through one prepared statement in transactions of BATCH_SIZE
+// records, with the database in WAL mode and synchronous=NORMAL: a crash can
+// lose the last uncommitted batch but never corrupts the file. A store is not
+// thread-safe; use one per thread.
+class ResultStore {
+public:
+    static constexpr size_t BATCH_SIZE = 10000;
+
+    ResultStore();
+    ~ResultStore();
+
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    // Opens or creates the database and its schema
+    bool open(const std::string& filename);
+    void close();
+    bool is_open() const { return m_db != nullptr; }
+
+    // Inserts or updates one record. A transaction is opened on the first call
+    // and committed every BATCH_SIZE records; call commit() (or close()) to
+    // make the remaining records durable.
+    bool upsert(const Business& business);
+    bool upsert(const std::vector<Business>& businesses);  // Bulk-loads large batches
+    bool commit();
+
+    // Brackets a run of upserts. When expected_records is large next to the
+    // store, the name/phone/domain indices are dropped until end_bulk()
+    // rebuilds them in one pass, which roughly doubles insert throughput;
+    // queries in between still work, without the indices.
+    bool begin_bulk(size_t expected_records);
+    bool end_bulk();
+
+    // Matching records in insertion order
+    bool query(const StoreQuery& query, std::vector<Business>& businesses);
+
+    // Number of stored records, or 0 on error
+    size_t count();
+
+    // Error handling
+    std::string last_error() const { return m_last_error; }
+
+private:
+    sqlite3* m_db;
+    sqlite3_stmt* m_upsert;
+    size_t m_pending;  // Records written in the open transaction
+    bool m_bulk;       // Indices dropped by begin_bulk()
+    std::string m_last_error;
+
+    bool execute(const char* sql);
+    bool fail(const std::string& context);
+};
+
+#endif
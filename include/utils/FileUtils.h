@@ -2,6 +2,7 @@
 #define FILE_UTILS_H
 
 #include <string>
+#include <vector>
 #include "output/Formatter.h"
 
 class FileUtils {
@@ -11,6 +12,9 @@ public:
     static bool create_directory(const std::string& directory_path);
     static bool file_exists(const std::string& filename);
     static bool directory_exists(const std::string& directory_path);
+    // Blank rows are skipped; line_numbers, if given, receives each row's first line (1-based)
+    static bool read_csv_file(const std::string& filename, std::vector<std::vector<std::string>>& rows,
+                              std::vector<size_t>* line_numbers = nullptr);
 
     // Filename generation
     static std::string get_timestamp_string();
@@ -1,8 +1,12 @@
 #include "core/Business.h"
+#include <limits>
 
 Business::Business()
     : m_total_ratings(0)
     , m_rating(0.0)
+    , m_latitude(std::numeric_limits<double>::quiet_NaN())
+    , m_longitude(std::numeric_limits<double>::quiet_NaN())
+    , m_fetched_at(0)
 {}
 
 Business::~Business() {}
\ No newline at end of file
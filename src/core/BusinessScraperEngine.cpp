@@ -2,7 +2,79 @@
 #include "scrapers/MapScraper.h"
 #include "scrapers/WebScraper.h"
 #include "output/Formatter.h"
+#include "output/ParquetWriter.h"
+#include "core/Checkpoint.h"
+#include "core/EntityResolver.h"
+#include "core/GeoIndex.h"
+#include "core/Trace.h"
+#include "core/ResultSpill.h"
+#include "utils/FileUtils.h"
+#include "storage/RecordFile.h"
+#include <json/json.h>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    // Identifies a batch job in the checkpoint journal
+    std::string batch_job_key(const SearchOptions& job) {
+        return job.keyword + "\t" + job.location + "\t" +
+               std::to_string(job.max_radius) + "\t" + std::to_string(job.max_results);
+    }
+
+    // Text Search returns at most three pages of 20 results per query
+    constexpr int PLACES_RESULT_CAP = 60;
+
+    // Mean position of the businesses that have coordinates
+    std::optional<GeoPoint> centroid_of(const std::vector<Business>& businesses) {
+        GeoPoint sum;
+        size_t count = 0;
+        for (const auto& business : businesses) {
+            if (business.has_coordinates()) {
+                sum.latitude += business.latitude();
+                sum.longitude += business.longitude();
+                count++;
+            }
+        }
+        if (count == 0) {
+            return std::nullopt;
+        }
+        return GeoPoint{sum.latitude / count, sum.longitude / count};
+    }
+
+    std::vector<std::string> strings_from_json(const Json::Value& array) {
+        std::vector<std::string> values;
+        for (const auto& value : array) {
+            values.push_back(value.asString());
+        }
+        return values;
+    }
+
+    // One record as written by the JSON and JSON Lines formats
+    Business business_from_json(const Json::Value& value) {
+        Business business;
+        business.set_place_id(value["place_id"].asString());
+        business.set_name(value["name"].asString());
+        business.set_address(value["address"].asString());
+        business.set_phone_number(value["phone_number"].asString());
+        business.set_email(value["email"].asString());
+        business.set_website(value["website"].asString());
+        business.set_rating(value["rating"].asDouble());
+        business.set_total_ratings(value["total_ratings"].asInt());
+        business.set_additional_numbers(strings_from_json(value["additional_numbers"]));
+        business.set_additional_emails(strings_from_json(value["additional_emails"]));
+        business.set_social_media_links(strings_from_json(value["social_media_links"]));
+        return business;
+    }
+} // end anonymous namespace
 
 BusinessScraperEngine::BusinessScraperEngine() {
     // Default empty callback
@@ -33,12 +105,16 @@ SearchResults BusinessScraperEngine::search_businesses(const SearchOptions& opti
         return results;
     }
 
+    TRACE_SCOPE("search_businesses");
+    ScopedLatency latency(&m_metrics, "search");
+
     try {
         notify_status("Initializing search...");
 
         // Create and configure MapScraper
         MapScraper scraper(m_api_key, options.keyword, options.location,
                           options.max_radius, options.max_results);
+        scraper.set_metrics(&m_metrics);
 
         notify_status("Searching for businesses...");
 
@@ -59,6 +135,7 @@ SearchResults BusinessScraperEngine::search_businesses(const SearchOptions& opti
             notify_status("Enhancing business data from websites...");
 
             WebScraper web_scraper;
+            web_scraper.set_metrics(&m_metrics);
             web_scraper.enhance_businesses(results.businesses);
 
             // Count how many were enhanced (have websites)
@@ -72,6 +149,16 @@ SearchResults BusinessScraperEngine::search_businesses(const SearchOptions& opti
             notify_status("Enhanced " + std::to_string(results.enhanced_count) + " businesses with website data");
         }
 
+        if (options.merge_duplicates) {
+            merge_duplicates(results);
+        }
+        if (options.merge_similar_names) {
+            merge_similar_names(results);
+        }
+        if (options.merge_nearby_meters > 0.0) {
+            merge_nearby(results, options.merge_nearby_meters);
+        }
+
         notify_status("Search completed successfully");
         results.success = true;
 
@@ -83,20 +170,822 @@ SearchResults BusinessScraperEngine::search_businesses(const SearchOptions& opti
     return results;
 }
 
+SearchResults BusinessScraperEngine::refresh_results(const SearchOptions& options, const SearchResults& previous,
+                                                     int64_t ttl_seconds) {
+    SearchResults results;
+
+    // Validate inputs
+    if (m_api_key.empty()) {
+        results.error_message = "API key not set";
+        return results;
+    }
+
+    if (options.keyword.empty() || options.location.empty()) {
+        results.error_message = "Keyword and location are required";
+        return results;
+    }
+
+    if (previous.spill) {
+        results.error_message = "The previous results must be loaded in memory";
+        return results;
+    }
+
+    // Records are matched by place ID; one without it would be fetched again as
+    // new, duplicated, and its old copy could never be refreshed
+    const size_t without_place_id = static_cast<size_t>(std::count_if(
+        previous.businesses.begin(), previous.businesses.end(),
+        [](const Business& business) { return business.place_id().empty(); }));
+    if (without_place_id > 0) {
+        results.error_message = std::to_string(without_place_id) + " previous records have no place ID; "
+                                "refresh needs search results saved as binary records or in a result store";
+        return results;
+    }
+
+    TRACE_SCOPE("refresh_results");
+    ScopedLatency latency(&m_metrics, "refresh");
+
+    try {
+        const int64_t now = static_cast<int64_t>(std::time(nullptr));
+        auto is_stale = [&](const Business& business) {
+            return business.fetched_at() <= 0 || now - business.fetched_at() >= ttl_seconds;
+        };
+
+        results.businesses = previous.businesses;
+        std::unordered_map<std::string, size_t> previous_index;
+        for (size_t i = 0; i < results.businesses.size(); ++i) {
+            if (!results.businesses[i].place_id().empty()) {
+                previous_index.emplace(results.businesses[i].place_id(), i);
+            }
+        }
+        std::vector<bool> refetched(results.businesses.size(), false);
+
+        notify_status("Searching for new businesses...");
+
+        // Search pages are cheap and reveal new place IDs; details are only
+        // fetched for places that are new or stale
+        MapScraper scraper(m_api_key, options.keyword, options.location, options.max_radius, options.max_results);
+        scraper.set_metrics(&m_metrics);
+        scraper.set_place_filter([&](const std::string& place_id) {
+            auto it = previous_index.find(place_id);
+            if (it == previous_index.end()) {
+                return true;
+            }
+            if (refetched[it->second] || !is_stale(results.businesses[it->second])) {
+                return false;
+            }
+            refetched[it->second] = true;
+            return true;
+        });
+
+        std::vector<Business> fetched = scraper.search_businesses();
+
+        // Stale records the search pages did not list are fetched by place ID
+        for (size_t i = 0; i < results.businesses.size(); ++i) {
+            const Business& business = results.businesses[i];
+            if (refetched[i] || business.place_id().empty() || !is_stale(business)) {
+                continue;
+            }
+            Business refreshed = scraper.fetch_business(business.place_id());
+            refetched[i] = true;
+            if (!refreshed.name().empty()) {
+                fetched.push_back(std::move(refreshed));
+            } else {
+                m_metrics.increment("errors", "refresh_fetch");
+            }
+        }
+
+        if (options.enhance_with_web_scraping && !fetched.empty()) {
+            notify_status("Enhancing " + std::to_string(fetched.size()) + " new or stale businesses from websites...");
+            WebScraper web_scraper;
+            web_scraper.set_metrics(&m_metrics);
+            web_scraper.enhance_businesses(fetched);
+        }
+
+        // Refetched records replace their old versions in place; new ones are appended
+        int new_count = 0;
+        for (auto& business : fetched) {
+            if (options.enhance_with_web_scraping && !business.website().empty()) {
+                results.enhanced_count++;
+            }
+            auto it = previous_index.find(business.place_id());
+            if (it != previous_index.end()) {
+                results.businesses[it->second] = std::move(business);
+                results.refreshed_count++;
+            } else {
+                results.businesses.push_back(std::move(business));
+                new_count++;
+            }
+        }
+
+        const int stale_count = static_cast<int>(std::count(refetched.begin(), refetched.end(), true));
+        results.reused_count = static_cast<int>(refetched.size()) - stale_count;
+        results.total_found = static_cast<int>(results.businesses.size());
+        m_metrics.increment("cache_hits", "refresh_fresh", results.reused_count);
+
+        notify_status("Refreshed " + std::to_string(results.refreshed_count) + " stale records, reused " +
+                      std::to_string(results.reused_count) + " and found " + std::to_string(new_count) + " new");
+        if (stale_count > results.refreshed_count) {
+            notify_status("Kept " + std::to_string(stale_count - results.refreshed_count) +
+                          " stale records whose details could not be fetched");
+        }
+
+        if (options.merge_duplicates) {
+            merge_duplicates(results);
+        }
+        if (options.merge_similar_names) {
+            merge_similar_names(results);
+        }
+        if (options.merge_nearby_meters > 0.0) {
+            merge_nearby(results, options.merge_nearby_meters);
+        }
+
+        results.success = true;
+
+    } catch (const std::exception& e) {
+        results.error_message = "Refresh failed: " + std::string(e.what());
+        notify_status(results.error_message);
+    }
+
+    return results;
+}
+
+SearchResults BusinessScraperEngine::search_batch(const BatchOptions& options) {
+    SearchResults results;
+
+    // Validate inputs
+    if (m_api_key.empty()) {
+        results.error_message = "API key not set";
+        return results;
+    }
+
+    if (options.jobs.empty()) {
+        results.error_message = "No batch jobs to run";
+        return results;
+    }
+
+    const size_t job_count = options.jobs.size();
+    const size_t worker_count = std::min(job_count, static_cast<size_t>(std::max(1, options.max_concurrency)));
+
+    notify_status("Running " + std::to_string(job_count) + " jobs with " +
+                  std::to_string(worker_count) + " workers...");
+
+    MapScraper::initialize_http();
+
+    // Shared between workers, guarded by results_mutex
+    std::mutex results_mutex;
+    std::unordered_set<std::string> seen_place_ids;
+    std::atomic<size_t> next_job(0);
+
+    // Centroid of each job's results, for saturation detection once all jobs finish
+    std::vector<std::optional<GeoPoint>> job_centers(job_count);
+
+    // Memory-bounded mode streams finished businesses into a spill file
+    if (options.memory_budget_bytes > 0) {
+        std::string spill_filename = options.spill_filename;
+        if (spill_filename.empty()) {
+            std::random_device random;
+            spill_filename = (std::filesystem::temp_directory_path() /
+                              ("business_scraper_" + FileUtils::get_timestamp_string() + "_" +
+                               std::to_string(random()) + ".spill")).string();
+        }
+
+        results.spill = std::make_shared<ResultSpill>(spill_filename, options.memory_budget_bytes);
+        if (!results.spill->last_error().empty()) {
+            results.error_message = results.spill->last_error();
+            return results;
+        }
+    }
+
+    // Must be called with results_mutex held (or before workers start)
+    auto add_result = [&](Business&& business) {
+        if (options.result_callback) {
+            options.result_callback(business);
+        }
+        if (results.spill) {
+            results.spill->append(std::move(business));
+        } else {
+            results.businesses.push_back(std::move(business));
+        }
+        results.total_found++;
+    };
+
+    // Resume from an existing journal: restored place IDs are never fetched again
+    Checkpoint checkpoint;
+    std::vector<Business> pending_enhancement;
+    std::atomic<size_t> next_pending(0);
+
+    if (!options.checkpoint_filename.empty()) {
+        if (!checkpoint.open(options.checkpoint_filename)) {
+            results.error_message = checkpoint.last_error();
+            return results;
+        }
+
+        for (auto& business : checkpoint.restored_businesses()) {
+            seen_place_ids.insert(business.place_id());
+            if (checkpoint.is_complete(business.place_id())) {
+                if (!business.website().empty()) {
+                    results.enhanced_count++;
+                }
+                add_result(std::move(business));
+            } else {
+                pending_enhancement.push_back(std::move(business));
+            }
+        }
+        results.resumed_count = static_cast<int>(checkpoint.restored_count());
+        m_metrics.increment("cache_hits", "checkpoint", checkpoint.restored_count());
+
+        if (results.resumed_count > 0) {
+            notify_status("Resumed " + std::to_string(results.resumed_count) + " businesses from checkpoint");
+        }
+    }
+
+    auto worker = [&]() {
+        WebScraper web_scraper;
+        web_scraper.set_metrics(&m_metrics);
+
+        // Finish website enhancement interrupted by the previous run first
+        for (size_t index = next_pending++; index < pending_enhancement.size(); index = next_pending++) {
+            Business& business = pending_enhancement[index];
+            try {
+                web_scraper.enhance_business(business);
+            } catch (const std::exception& e) {
+                notify_status("Enhancing " + business.name() + " failed: " + std::string(e.what()));
+            }
+            checkpoint.record_business(business, true);
+
+            std::lock_guard<std::mutex> lock(results_mutex);
+            if (!business.website().empty()) {
+                results.enhanced_count++;
+            }
+            add_result(std::move(business));
+        }
+
+        for (size_t index = next_job++; index < job_count; index = next_job++) {
+            const SearchOptions& job = options.jobs[index];
+            std::string job_label = "[" + std::to_string(index + 1) + "/" + std::to_string(job_count) + "] '" +
+                                    job.keyword + "' in '" + job.location + "'";
+
+            if (job.keyword.empty() || job.location.empty()) {
+                notify_status("Skipping job " + job_label + ": keyword and location are required");
+                continue;
+            }
+
+            const std::string job_key = batch_job_key(job);
+            if (checkpoint.is_job_completed(job_key)) {
+                std::lock_guard<std::mutex> lock(results_mutex);
+                results.jobs_completed++;
+                notify_status("Skipping job " + job_label + ": already completed");
+                continue;
+            }
+
+            try {
+                TRACE_SCOPE("batch_job");
+                ScopedLatency job_latency(&m_metrics, "batch_job");
+                MapScraper scraper(m_api_key, job.keyword, job.location, job.max_radius, job.max_results);
+                scraper.set_metrics(&m_metrics);
+
+                // Claim each place ID before fetching its details so no two jobs fetch the same place
+                scraper.set_place_filter([&](const std::string& place_id) {
+                    std::lock_guard<std::mutex> lock(results_mutex);
+                    if (seen_place_ids.insert(place_id).second) {
+                        return true;
+                    }
+                    results.duplicates_skipped++;
+                    m_metrics.increment("cache_hits", "place_dedup");
+                    return false;
+                });
+
+                // Places this job fetched before an interruption are restored already;
+                // they still count toward its max_results, so the rerun fetches only
+                // what the job had left
+                if (checkpoint.restored_count() > 0) {
+                    scraper.set_place_known([&](const std::string& place_id) {
+                        return checkpoint.place_job(place_id) == job_key;
+                    });
+                }
+
+                // A place whose details failed to load is not a duplicate; let later jobs fetch it
+                scraper.set_place_release([&](const std::string& place_id) {
+                    std::lock_guard<std::mutex> lock(results_mutex);
+                    seen_place_ids.erase(place_id);
+                });
+
+                // Journal each business as soon as its details arrive
+                scraper.set_business_callback([&](const Business& business) {
+                    checkpoint.record_business(business, !job.enhance_with_web_scraping || business.website().empty(),
+                                               job_key);
+                });
+
+                std::vector<Business> businesses = scraper.search_businesses();
+                std::optional<GeoPoint> centroid = centroid_of(businesses);
+
+                if (job.enhance_with_web_scraping) {
+                    for (auto& business : businesses) {
+                        if (web_scraper.enhance_business(business)) {
+                            checkpoint.record_business(business, true, job_key);
+                        }
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(results_mutex);
+                for (auto& business : businesses) {
+                    if (job.enhance_with_web_scraping && !business.website().empty()) {
+                        results.enhanced_count++;
+                    }
+                    add_result(std::move(business));
+                }
+                job_centers[index] = centroid;
+                results.jobs_completed++;
+                checkpoint.record_job_completed(job_key);
+
+                notify_status("Completed job " + job_label + ": " + std::to_string(businesses.size()) +
+                              " new businesses");
+            } catch (const std::exception& e) {
+                m_metrics.increment("errors", "job_exception");
+                notify_status("Job " + job_label + " failed: " + std::string(e.what()));
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    // A failed spill write keeps the results in memory, over the budget
+    if (results.spill && !results.spill->last_error().empty()) {
+        notify_status("Memory budget exceeded: " + results.spill->last_error());
+        m_metrics.increment("errors", "spill_write");
+    }
+
+    if (results.jobs_completed == 0) {
+        results.error_message = "All batch jobs failed";
+        notify_status("Batch failed: " + results.error_message);
+        return results;
+    }
+
+    // A tile is saturated when its area holds as many results as one query can
+    // return: the API stopped at its cap, so the tile likely has more to find
+    if (!results.spill) {
+        GeoIndex index;
+        index.build(results.businesses);
+        for (size_t i = 0; i < job_count && !index.empty(); ++i) {
+            if (!job_centers[i]) continue;
+            const SearchOptions& job = options.jobs[i];
+            size_t cap = static_cast<size_t>(std::min(job.max_results, PLACES_RESULT_CAP));
+            size_t found = index.count_radius(*job_centers[i], job.max_radius);
+            if (found >= cap) {
+                results.saturated_jobs.push_back(static_cast<int>(i));
+                notify_status("Job " + std::to_string(i + 1) + " ('" + job.keyword + "' in '" + job.location +
+                              "') is saturated: " + std::to_string(found) + " results within its radius; "
+                              "split it into smaller tiles");
+            }
+        }
+        m_metrics.increment("saturated_jobs", "", results.saturated_jobs.size());
+    }
+
+    if (options.merge_duplicates) {
+        merge_duplicates(results);
+    }
+    if (options.merge_similar_names) {
+        merge_similar_names(results);
+    }
+    if (options.merge_nearby_meters > 0.0) {
+        merge_nearby(results, options.merge_nearby_meters);
+    }
+
+    notify_status("Batch completed: " + std::to_string(results.total_found) + " unique businesses from " +
+                  std::to_string(results.jobs_completed) + " jobs (" +
+                  std::to_string(results.duplicates_skipped) + " duplicates skipped)");
+    results.success = true;
+
+    return results;
+}
+
+int BusinessScraperEngine::merge_duplicates(SearchResults& results) {
+    if (results.spill) {
+        notify_status("Skipping duplicate merging: results were spilled to disk");
+        return 0;
+    }
+
+    TRACE_SCOPE("merge_duplicates");
+    ScopedLatency latency(&m_metrics, "entity_resolution");
+
+    EntityResolver resolver;
+    int merged = static_cast<int>(resolver.resolve(results.businesses));
+
+    results.merged_count += merged;
+    results.total_found = static_cast<int>(results.businesses.size());
+    m_metrics.increment("merged_records", "", merged);
+
+    if (merged > 0) {
+        notify_status("Merged " + std::to_string(merged) + " duplicate records");
+    }
+    return merged;
+}
+
+int BusinessScraperEngine::merge_similar_names(SearchResults& results) {
+    if (results.spill) {
+        notify_status("Skipping similar name merging: results were spilled to disk");
+        return 0;
+    }
+
+    TRACE_SCOPE("merge_similar_names");
+    ScopedLatency latency(&m_metrics, "similar_name_resolution");
+
+    EntityResolver resolver;
+    int merged = static_cast<int>(resolver.resolve_similar_names(results.businesses));
+
+    results.similar_names_merged += merged;
+    results.total_found = static_cast<int>(results.businesses.size());
+    m_metrics.increment("similar_name_merges", "", merged);
+
+    if (merged > 0) {
+        notify_status("Merged " + std::to_string(merged) + " records with similar names");
+    }
+    return merged;
+}
+
+int BusinessScraperEngine::merge_nearby(SearchResults& results, double max_distance_meters) {
+    if (results.spill) {
+        notify_status("Skipping nearby merging: results were spilled to disk");
+        return 0;
+    }
+
+    TRACE_SCOPE("merge_nearby");
+    ScopedLatency latency(&m_metrics, "nearby_resolution");
+
+    EntityResolver resolver;
+    int merged = static_cast<int>(resolver.resolve_nearby(results.businesses, max_distance_meters));
+
+    results.nearby_merged += merged;
+    results.total_found = static_cast<int>(results.businesses.size());
+    m_metrics.increment("nearby_merges", "", merged);
+
+    if (merged > 0) {
+        notify_status("Merged " + std::to_string(merged) + " nearby records with similar names");
+    }
+    return merged;
+}
+
 void BusinessScraperEngine::set_status_callback(std::function<void(const std::string&)> callback) {
     m_status_callback = callback ? callback : [](const std::string&) {};
 }
 
 std::string BusinessScraperEngine::format_results(const SearchResults& results, OutputFormat format) const {
-    if (!results.success || results.businesses.empty()) {
+    if (!results.success || (results.businesses.empty() && (!results.spill || results.spill->empty()))) {
         return "";
     }
 
+    std::string output;
+    StringSink sink(output);
+    if (!write_results(results, format, sink) || !sink.flush()) {
+        return "";
+    }
+    return output;
+}
+
+bool BusinessScraperEngine::write_results(const SearchResults& results, OutputFormat format, OutputSink& sink) const {
+    TRACE_SCOPE("write_results");
+    ScopedLatency latency(&m_metrics, "formatting");
+
     Formatter formatter(format);
-    return formatter.format_businesses(results.businesses);
+    formatter.set_fields(m_output_fields);
+    formatter.set_threads(m_output_threads);
+    formatter.begin(sink);
+
+    size_t index = 0;
+    if (!results.spill) {
+        formatter.write_records(sink, results.businesses);
+        index = results.businesses.size();
+    } else if (formatter.effective_threads() < 2) {
+        // Stream record by record so a spilled result set is never fully resident
+        bool read = results.spill->for_each([&](const Business& business) {
+            formatter.write_record(sink, business, index++);
+        });
+        if (!read) return false;
+    } else {
+        // Read back a batch at a time, enough to keep every thread busy but
+        // within the spill's memory budget: a quarter of it for the records, at
+        // most as much again for the batch's slots (reserved once, so the
+        // vector never reallocates) and the rest for the formatted text of the
+        // chunks in flight. A batch is never cut below one chunk.
+        const size_t max_bytes = results.spill->memory_budget() / 4;
+        const size_t max_records = std::min(Formatter::CHUNK_RECORDS * formatter.effective_threads() * 2,
+                                            std::max(Formatter::CHUNK_RECORDS, max_bytes / sizeof(Business) + 1));
+        std::vector<Business> batch;
+        batch.reserve(max_records);
+        size_t batch_bytes = 0;
+        auto write_batch = [&]() {
+            formatter.write_records(sink, batch, index);
+            index += batch.size();
+            batch.clear();
+            batch_bytes = 0;
+        };
+
+        bool read = results.spill->for_each([&](const Business& business) {
+            batch.push_back(business);
+            batch_bytes += ResultSpill::estimated_size(business);
+            if (batch.size() == max_records || (batch.size() >= Formatter::CHUNK_RECORDS && batch_bytes >= max_bytes)) {
+                write_batch();
+            }
+        });
+        if (!read) return false;
+        write_batch();
+    }
+    formatter.end(sink, index);
+
+    return sink.ok();
+}
+
+bool BusinessScraperEngine::write_results(const SearchResults& results, OutputFormat format, std::ostream& out) const {
+    StreamSink sink(out);
+    return write_results(results, format, sink) && sink.flush();
+}
+
+bool BusinessScraperEngine::save_results(const SearchResults& results, OutputFormat format, const std::string& filename,
+                                         std::string& error_message, Compression compression) const {
+    FileSink sink;
+    if (!sink.open_atomic(filename)) {
+        error_message = sink.last_error();
+        return false;
+    }
+
+    bool written;
+    if (compression == Compression::None) {
+        written = write_results(results, format, sink);
+    } else {
+        CompressedSink compressed(sink, compression);
+        written = write_results(results, format, compressed);
+        if (!compressed.finish()) {
+            error_message = compressed.last_error();
+            sink.close();
+            return false;
+        }
+        m_metrics.increment("output_bytes", "uncompressed", compressed.bytes_in());
+        m_metrics.increment("output_bytes", "compressed", compressed.bytes_out());
+    }
+
+    if (!written) {
+        // Either the file or, for spilled results, reading them back failed
+        sink.close();
+        error_message = sink.ok() && results.spill ? results.spill->last_error() : sink.last_error();
+        return false;
+    }
+    if (!sink.commit()) {
+        error_message = sink.last_error();
+        return false;
+    }
+    return true;
+}
+
+bool BusinessScraperEngine::save_records(const SearchResults& results, const std::string& filename, std::string& error_message) const {
+    TRACE_SCOPE("save_records");
+    ScopedLatency latency(&m_metrics, "formatting");
+
+    RecordFileWriter writer;
+    if (!writer.open(filename)) {
+        error_message = writer.last_error();
+        return false;
+    }
+
+    bool ok = true;
+    auto write = [&](const Business& business) {
+        ok = ok && writer.write(business);
+    };
+
+    if (results.spill) {
+        if (!results.spill->for_each(write)) {
+            error_message = results.spill->last_error();
+            return false;
+        }
+    } else {
+        for (const auto& business : results.businesses) {
+            write(business);
+        }
+    }
+
+    if (!writer.close() || !ok) {
+        error_message = writer.last_error();
+        return false;
+    }
+    return true;
+}
+
+bool BusinessScraperEngine::save_parquet(const SearchResults& results, const std::string& filename,
+                                         std::string& error_message, Compression compression) const {
+    TRACE_SCOPE("save_parquet");
+    ScopedLatency latency(&m_metrics, "formatting");
+
+    ParquetWriter writer;
+    if (!writer.open(filename, compression)) {
+        error_message = writer.last_error();
+        return false;
+    }
+
+    bool ok = true;
+    auto write = [&](const Business& business) {
+        ok = ok && writer.write(business);
+    };
+
+    if (results.spill) {
+        if (!results.spill->for_each(write)) {
+            error_message = results.spill->last_error();
+            return false;
+        }
+    } else {
+        for (const auto& business : results.businesses) {
+            write(business);
+        }
+    }
+
+    if (!writer.close() || !ok) {
+        error_message = writer.last_error();
+        return false;
+    }
+    return true;
+}
+
+SearchResults BusinessScraperEngine::load_records(const std::string& filename) const {
+    TRACE_SCOPE("load_records");
+    SearchResults results;
+
+    RecordFileReader reader;
+    if (!reader.open(filename)) {
+        results.error_message = reader.last_error();
+        return results;
+    }
+
+    results.businesses.reserve(reader.size());
+    RecordView view;
+    for (size_t i = 0; i < reader.size(); ++i) {
+        if (!reader.read(i, view)) {
+            results.businesses.clear();
+            results.error_message = reader.last_error();
+            return results;
+        }
+        results.businesses.push_back(view.to_business());
+    }
+
+    results.total_found = static_cast<int>(results.businesses.size());
+    results.success = true;
+    return results;
+}
+
+bool BusinessScraperEngine::save_to_store(const SearchResults& results, const std::string& filename,
+                                          std::string& error_message) const {
+    TRACE_SCOPE("save_to_store");
+    ScopedLatency latency(&m_metrics, "store");
+
+    ResultStore store;
+    if (!store.open(filename)) {
+        error_message = store.last_error();
+        return false;
+    }
+
+    bool ok = store.begin_bulk(static_cast<size_t>(results.total_found));
+    auto upsert = [&](const Business& business) {
+        ok = ok && store.upsert(business);
+    };
+
+    if (results.spill) {
+        if (!results.spill->for_each(upsert)) {
+            error_message = results.spill->last_error();
+            return false;
+        }
+    } else {
+        for (const auto& business : results.businesses) {
+            upsert(business);
+        }
+    }
+
+    if (!ok || !store.end_bulk() || !store.commit()) {
+        error_message = store.last_error();
+        return false;
+    }
+    m_metrics.increment("stored_records", "", static_cast<uint64_t>(results.total_found));
+    return true;
+}
+
+SearchResults BusinessScraperEngine::query_store(const std::string& filename, const StoreQuery& query) const {
+    TRACE_SCOPE("query_store");
+    ScopedLatency latency(&m_metrics, "store");
+    SearchResults results;
+
+    ResultStore store;
+    if (!store.open(filename) || !store.query(query, results.businesses)) {
+        results.businesses.clear();
+        results.error_message = store.last_error();
+        return results;
+    }
+
+    results.total_found = static_cast<int>(results.businesses.size());
+    results.success = true;
+    return results;
+}
+
+SearchResults BusinessScraperEngine::load_results(const std::string& filename) const {
+    std::string extension = std::filesystem::path(filename).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == std::string(".") + ResultStoreFile::EXTENSION) {
+        return query_store(filename, StoreQuery());
+    }
+    if (extension != ".json" && extension != ".jsonl") {
+        return load_records(filename);
+    }
+
+    TRACE_SCOPE("load_json");
+    SearchResults results;
+
+    std::ifstream file(filename);
+    if (!file) {
+        results.error_message = "Cannot open " + filename;
+        return results;
+    }
+
+    if (extension == ".jsonl") {
+        // One object per line; a partial last line from an interrupted writer is skipped
+        std::unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder().newCharReader());
+        std::string line;
+        size_t line_number = 0;
+        while (std::getline(file, line)) {
+            ++line_number;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+            Json::Value value;
+            std::string parse_errors;
+            if (!reader->parse(line.data(), line.data() + line.size(), &value, &parse_errors) || !value.isObject()) {
+                if (file.eof()) break;
+                results.error_message = "Invalid JSON on line " + std::to_string(line_number) + " of " + filename;
+                return results;
+            }
+            results.businesses.push_back(business_from_json(value));
+        }
+
+        results.total_found = static_cast<int>(results.businesses.size());
+        results.success = true;
+        return results;
+    }
+
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    std::string parse_errors;
+    if (!Json::parseFromStream(builder, file, &root, &parse_errors) || !root["businesses"].isArray()) {
+        results.error_message = "Not a JSON results file: " + filename +
+                                (parse_errors.empty() ? "" : " (" + parse_errors + ")");
+        return results;
+    }
+
+    const Json::Value& businesses = root["businesses"];
+    results.businesses.reserve(businesses.size());
+    for (const auto& value : businesses) {
+        results.businesses.push_back(business_from_json(value));
+    }
+
+    results.total_found = static_cast<int>(results.businesses.size());
+    results.success = true;
+    return results;
+}
+
+bool BusinessScraperEngine::diff_results(const SearchResults& previous, const SearchResults& current, ResultDiff& diff,
+                                         std::string& error_message) const {
+    TRACE_SCOPE("diff_results");
+    ScopedLatency latency(&m_metrics, "diff");
+
+    if (previous.spill) {
+        error_message = "The previous run must be loaded in memory";
+        return false;
+    }
+
+    ChangeDetector detector(previous.businesses);
+    auto add = [&](const Business& business) {
+        detector.add(business);
+    };
+
+    if (current.spill) {
+        if (!current.spill->for_each(add)) {
+            error_message = current.spill->last_error();
+            return false;
+        }
+    } else {
+        for (const auto& business : current.businesses) {
+            add(business);
+        }
+    }
+
+    diff = detector.finish();
+    m_metrics.increment("diff_records", "added", diff.added.size());
+    m_metrics.increment("diff_records", "removed", diff.removed.size());
+    m_metrics.increment("diff_records", "changed", diff.changed.size());
+    return true;
 }
 
 void BusinessScraperEngine::notify_status(const std::string& message) {
+    std::lock_guard<std::mutex> lock(m_status_mutex);
     if (m_status_callback) {
         m_status_callback(message);
     }
@@ -0,0 +1,189 @@
+#include "core/ChangeDetector.h"
+#include "core/EntityResolver.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+    // Separates fields so ("ab", "c") and ("a", "bc") hash differently
+    constexpr unsigned char FIELD_SEPARATOR = 0x1F;
+
+    class Fnv1a {
+    public:
+        void byte(unsigned char value) {
+            m_state = (m_state ^ value) * FNV_PRIME;
+        }
+
+        void bytes(std::string_view value) {
+            for (char c : value) {
+                byte(static_cast<unsigned char>(c));
+            }
+            byte(FIELD_SEPARATOR);
+        }
+
+        // Fixed little-endian order keeps fingerprints portable
+        void integer(int64_t value) {
+            uint64_t bits = static_cast<uint64_t>(value);
+            for (int shift = 0; shift < 64; shift += 8) {
+                byte(static_cast<unsigned char>((bits >> shift) & 0xFF));
+            }
+            byte(FIELD_SEPARATOR);
+        }
+
+        // Hashes value lowercased and trimmed, with each whitespace run reduced
+        // to one space, without materialising the normalised string
+        void normalized_text(std::string_view value) {
+            bool pending_space = false;
+            bool started = false;
+            for (char c : value) {
+                // ASCII-only case folding, independent of the C locale
+                unsigned char byte_value = static_cast<unsigned char>(c);
+                if (byte_value == ' ' || (byte_value >= '\t' && byte_value <= '\r')) {
+                    pending_space = started;
+                    continue;
+                }
+                if (pending_space) {
+                    byte(' ');
+                    pending_space = false;
+                }
+                if (byte_value >= 'A' && byte_value <= 'Z') {
+                    byte_value = static_cast<unsigned char>(byte_value - 'A' + 'a');
+                }
+                byte(byte_value);
+                started = true;
+            }
+            byte(FIELD_SEPARATOR);
+        }
+
+        uint64_t value() const { return m_state; }
+
+    private:
+        uint64_t m_state = FNV_OFFSET_BASIS;
+    };
+
+    // Order-insensitive: elements are hashed individually and their hashes sorted
+    void hash_list(Fnv1a& hasher, const std::vector<std::string>& values) {
+        std::vector<uint64_t> element_hashes;
+        element_hashes.reserve(values.size());
+        for (const auto& value : values) {
+            Fnv1a element;
+            element.normalized_text(value);
+            element_hashes.push_back(element.value());
+        }
+        std::sort(element_hashes.begin(), element_hashes.end());
+
+        hasher.integer(static_cast<int64_t>(element_hashes.size()));
+        for (uint64_t element_hash : element_hashes) {
+            hasher.integer(static_cast<int64_t>(element_hash));
+        }
+    }
+} // end anonymous namespace
+
+ChangeDetector::ChangeDetector(std::vector<Business> previous)
+    : m_previous(std::move(previous))
+    , m_matched(m_previous.size(), false)
+    , m_name_address_indexed(false)
+{
+    m_previous_fingerprints.reserve(m_previous.size());
+    m_by_place_id.reserve(m_previous.size());
+
+    for (size_t i = 0; i < m_previous.size(); ++i) {
+        const Business& business = m_previous[i];
+        m_previous_fingerprints.push_back(fingerprint(business));
+        if (!business.place_id().empty()) {
+            m_by_place_id.emplace(place_key(business), i);
+        } else {
+            m_by_name_address.emplace(name_address_key(business), i);
+        }
+    }
+}
+
+ChangeDetector::~ChangeDetector() {}
+
+void ChangeDetector::add(const Business& current) {
+    // Prefer the place ID; fall back to name and address for outputs without IDs
+    size_t match = m_previous.size();
+    if (!current.place_id().empty()) {
+        auto it = m_by_place_id.find(place_key(current));
+        if (it != m_by_place_id.end() && !m_matched[it->second]) {
+            match = it->second;
+        }
+    }
+    if (match == m_previous.size()) {
+        // Previous records with place IDs are only needed here when the current
+        // record has none, so they are indexed on first such record
+        if (current.place_id().empty() && !m_name_address_indexed) {
+            for (size_t i = 0; i < m_previous.size(); ++i) {
+                if (!m_previous[i].place_id().empty()) {
+                    m_by_name_address.emplace(name_address_key(m_previous[i]), i);
+                }
+            }
+            m_name_address_indexed = true;
+        }
+        auto it = m_by_name_address.find(name_address_key(current));
+        if (it != m_by_name_address.end() && !m_matched[it->second]) {
+            match = it->second;
+        }
+    }
+
+    if (match == m_previous.size()) {
+        m_diff.added.push_back(current);
+        return;
+    }
+
+    m_matched[match] = true;
+    if (fingerprint(current) == m_previous_fingerprints[match]) {
+        m_diff.unchanged++;
+    } else {
+        m_diff.changed.push_back(current);
+    }
+}
+
+ResultDiff ChangeDetector::finish() {
+    for (size_t i = 0; i < m_previous.size(); ++i) {
+        if (!m_matched[i]) {
+            m_diff.removed.push_back(std::move(m_previous[i]));
+        }
+    }
+    m_previous.clear();
+    m_matched.clear();
+    return std::move(m_diff);
+}
+
+ResultDiff ChangeDetector::compare(std::vector<Business> previous, const std::vector<Business>& current) {
+    ChangeDetector detector(std::move(previous));
+    for (const auto& business : current) {
+        detector.add(business);
+    }
+    return detector.finish();
+}
+
+uint64_t ChangeDetector::fingerprint(const Business& business) {
+    Fnv1a hasher;
+    hasher.normalized_text(business.name());
+    hasher.normalized_text(business.address());
+    hasher.normalized_text(business.phone_number());
+    hasher.normalized_text(business.email());
+    hasher.normalized_text(business.website());
+    hasher.integer(std::llround(business.rating() * 100.0));
+    hasher.integer(business.total_ratings());
+    hash_list(hasher, business.additional_numbers());
+    hash_list(hasher, business.additional_emails());
+    hash_list(hasher, business.social_media_links());
+    return hasher.value();
+}
+
+uint64_t ChangeDetector::place_key(const Business& business) {
+    Fnv1a hasher;
+    hasher.bytes(business.place_id());
+    return hasher.value();
+}
+
+uint64_t ChangeDetector::name_address_key(const Business& business) {
+    Fnv1a hasher;
+    hasher.bytes(EntityResolver::normalize_name(business.name()));
+    hasher.bytes(EntityResolver::normalize_address(business.address()));
+    return hasher.value();
+}
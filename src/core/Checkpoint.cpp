@@ -0,0 +1,223 @@
+#include "core/Checkpoint.h"
+#include <json/json.h>
+#include <memory>
+
+namespace {
+    Json::Value strings_to_json(const std::vector<std::string>& values) {
+        Json::Value array(Json::arrayValue);
+        for (const auto& value : values) {
+            array.append(value);
+        }
+        return array;
+    }
+
+    std::vector<std::string> strings_from_json(const Json::Value& array) {
+        std::vector<std::string> values;
+        if (array.isArray()) {
+            for (const auto& value : array) {
+                values.push_back(value.asString());
+            }
+        }
+        return values;
+    }
+
+    Json::Value business_to_json(const Business& business) {
+        Json::Value value;
+        value["place_id"] = business.place_id();
+        value["name"] = business.name();
+        value["address"] = business.address();
+        value["phone_number"] = business.phone_number();
+        value["email"] = business.email();
+        value["website"] = business.website();
+        value["rating"] = business.rating();
+        value["total_ratings"] = business.total_ratings();
+        if (business.has_coordinates()) {
+            value["latitude"] = business.latitude();
+            value["longitude"] = business.longitude();
+        }
+        value["fetched_at"] = static_cast<Json::Int64>(business.fetched_at());
+        value["additional_numbers"] = strings_to_json(business.additional_numbers());
+        value["additional_emails"] = strings_to_json(business.additional_emails());
+        value["social_media_links"] = strings_to_json(business.social_media_links());
+        return value;
+    }
+
+    Business business_from_json(const Json::Value& value) {
+        Business business;
+        business.set_place_id(value["place_id"].asString());
+        business.set_name(value["name"].asString());
+        business.set_address(value["address"].asString());
+        business.set_phone_number(value["phone_number"].asString());
+        business.set_email(value["email"].asString());
+        business.set_website(value["website"].asString());
+        business.set_rating(value["rating"].asDouble());
+        business.set_total_ratings(value["total_ratings"].asInt());
+        if (value["latitude"].isNumeric() && value["longitude"].isNumeric()) {
+            business.set_coordinates(value["latitude"].asDouble(), value["longitude"].asDouble());
+        }
+        business.set_fetched_at(value["fetched_at"].asInt64());
+        business.set_additional_numbers(strings_from_json(value["additional_numbers"]));
+        business.set_additional_emails(strings_from_json(value["additional_emails"]));
+        business.set_social_media_links(strings_from_json(value["social_media_links"]));
+        return business;
+    }
+
+    std::string to_line(const Json::Value& value) {
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        return Json::writeString(builder, value);
+    }
+} // end anonymous namespace
+
+Checkpoint::Checkpoint() {}
+
+Checkpoint::~Checkpoint() {
+    close();
+}
+
+bool Checkpoint::open(const std::string& filename) {
+    close();
+    m_last_error.clear();
+
+    if (!load(filename)) {
+        return false;
+    }
+
+    m_file.open(filename, std::ios::app);
+    if (!m_file.is_open()) {
+        m_last_error = "Could not open checkpoint file: " + filename;
+        return false;
+    }
+
+    // Terminate a line left half-written by a crash so new entries start cleanly
+    m_file << '\n';
+    m_file.flush();
+
+    return true;
+}
+
+void Checkpoint::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+bool Checkpoint::load(const std::string& filename) {
+    m_completed_jobs.clear();
+    m_entries.clear();
+    m_order.clear();
+
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        // No journal yet: start fresh
+        return true;
+    }
+
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string line;
+
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        // A line that fails to parse was cut short by a crash; skip it
+        Json::Value entry;
+        std::string errors;
+        if (!reader->parse(line.data(), line.data() + line.size(), &entry, &errors) || !entry.isObject()) {
+            continue;
+        }
+
+        const std::string type = entry["type"].asString();
+        if (type == "job") {
+            m_completed_jobs.insert(entry["key"].asString());
+        } else if (type == "business") {
+            Business business = business_from_json(entry["business"]);
+            const std::string place_id = business.place_id();
+            if (place_id.empty()) {
+                continue;
+            }
+
+            auto it = m_entries.find(place_id);
+            if (it == m_entries.end()) {
+                m_order.push_back(place_id);
+                it = m_entries.emplace(place_id, Entry()).first;
+            }
+
+            // Later entries supersede earlier ones (details, then website data)
+            it->second.business = business;
+            it->second.complete = it->second.complete || entry["complete"].asBool();
+            if (it->second.job_key.empty()) {
+                it->second.job_key = entry["job"].asString();
+            }
+        }
+    }
+
+    return true;
+}
+
+bool Checkpoint::is_job_completed(const std::string& job_key) const {
+    return m_completed_jobs.find(job_key) != m_completed_jobs.end();
+}
+
+bool Checkpoint::has_place(const std::string& place_id) const {
+    return m_entries.find(place_id) != m_entries.end();
+}
+
+bool Checkpoint::is_complete(const std::string& place_id) const {
+    auto it = m_entries.find(place_id);
+    return it != m_entries.end() && it->second.complete;
+}
+
+std::string Checkpoint::place_job(const std::string& place_id) const {
+    auto it = m_entries.find(place_id);
+    return it != m_entries.end() ? it->second.job_key : std::string();
+}
+
+std::vector<Business> Checkpoint::restored_businesses() const {
+    std::vector<Business> businesses;
+    businesses.reserve(m_order.size());
+    for (const auto& place_id : m_order) {
+        businesses.push_back(m_entries.at(place_id).business);
+    }
+    return businesses;
+}
+
+void Checkpoint::record_business(const Business& business, bool complete, const std::string& job_key) {
+    if (!is_open()) {
+        return;
+    }
+
+    Json::Value entry;
+    entry["type"] = "business";
+    entry["complete"] = complete;
+    if (!job_key.empty()) {
+        entry["job"] = job_key;
+    }
+    entry["business"] = business_to_json(business);
+    append_line(to_line(entry));
+}
+
+void Checkpoint::record_job_completed(const std::string& job_key) {
+    if (!is_open()) {
+        return;
+    }
+
+    Json::Value entry;
+    entry["type"] = "job";
+    entry["key"] = job_key;
+    append_line(to_line(entry));
+}
+
+void Checkpoint::append_line(const std::string& line) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file.is_open()) {
+        return;
+    }
+
+    // Flush every entry so it survives the process dying right after
+    m_file << line << '\n';
+    m_file.flush();
+}
@@ -0,0 +1,502 @@
+#include "core/EntityResolver.h"
+#include "core/GeoIndex.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+
+namespace {
+    // Hosts shared by unrelated businesses, so useless as an identity key
+    const char* const SHARED_HOSTS[] = {
+        "facebook.com", "instagram.com", "twitter.com", "linkedin.com", "youtube.com", "tiktok.com",
+        "google.com", "sites.google.com", "business.site", "yelp.com", "linktr.ee", "wixsite.com",
+        "squarespace.com", "godaddysites.com"
+    };
+
+    // Common street-address words reduced to their postal abbreviations
+    const std::pair<std::string_view, std::string_view> ADDRESS_ABBREVIATIONS[] = {
+        {"street", "st"}, {"avenue", "ave"}, {"road", "rd"}, {"boulevard", "blvd"}, {"drive", "dr"},
+        {"lane", "ln"}, {"court", "ct"}, {"place", "pl"}, {"highway", "hwy"}, {"parkway", "pkwy"},
+        {"square", "sq"}, {"suite", "ste"}, {"floor", "fl"}, {"north", "n"}, {"south", "s"},
+        {"east", "e"}, {"west", "w"}
+    };
+
+    // Words that do not distinguish one business name from another
+    const std::string_view NAME_STOP_WORDS[] = {
+        "the", "and", "inc", "llc", "ltd", "co", "corp", "company"
+    };
+
+    // MinHash signature layout for fuzzy name matching: BANDS bands of
+    // BAND_ROWS rows. Two rows per band makes names with a trigram Jaccard
+    // similarity of 0.5 collide in some band about 90% of the time.
+    constexpr size_t SHINGLE_LENGTH = 3;
+    constexpr size_t BAND_ROWS = 2;
+    constexpr size_t BANDS = 8;
+    constexpr size_t SIGNATURE_LENGTH = BAND_ROWS * BANDS;
+
+    class DisjointSet {
+    public:
+        explicit DisjointSet(size_t size) : m_parent(size) {
+            std::iota(m_parent.begin(), m_parent.end(), 0);
+        }
+
+        size_t find(size_t index) {
+            while (m_parent[index] != index) {
+                m_parent[index] = m_parent[m_parent[index]];
+                index = m_parent[index];
+            }
+            return index;
+        }
+
+        // The lower index becomes the root so the earliest record survives
+        void unite(size_t a, size_t b) {
+            a = find(a);
+            b = find(b);
+            if (a != b) {
+                m_parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+
+    private:
+        std::vector<size_t> m_parent;
+    };
+
+    // Open-addressing hash index from key to the first record that used it.
+    // Flat storage keeps a few hundred thousand lookups cache-friendly.
+    class KeyIndex {
+    public:
+        explicit KeyIndex(size_t expected_keys) {
+            size_t capacity = 16;
+            while (capacity < expected_keys * 2) {
+                capacity <<= 1;
+            }
+            m_keys.assign(capacity, 0);
+            m_records.resize(capacity);
+        }
+
+        // Returns the record that first claimed key, or record if the key is new
+        size_t claim(uint64_t key, size_t record) {
+            if (key == 0) key = 1;  // 0 marks an empty slot
+            size_t mask = m_keys.size() - 1;
+            for (size_t slot = key & mask;; slot = (slot + 1) & mask) {
+                if (m_keys[slot] == key) {
+                    return m_records[slot];
+                }
+                if (m_keys[slot] == 0) {
+                    m_keys[slot] = key;
+                    m_records[slot] = record;
+                    return record;
+                }
+            }
+        }
+
+    private:
+        std::vector<uint64_t> m_keys;
+        std::vector<size_t> m_records;
+    };
+
+    // Order-dependent 64-bit mix (splitmix64 finaliser)
+    uint64_t combine_hash(uint64_t seed, uint64_t value) {
+        uint64_t x = seed * 0x9E3779B97F4A7C15ULL + value;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    std::array<uint64_t, SIGNATURE_LENGTH> minhash_signature(const std::string& name) {
+        std::array<uint64_t, SIGNATURE_LENGTH> signature;
+        signature.fill(UINT64_MAX);
+
+        // Pad so short names and word boundaries still produce shingles
+        std::string padded = " " + name + " ";
+        std::hash<std::string_view> hasher;
+        for (size_t i = 0; i + SHINGLE_LENGTH <= padded.size(); ++i) {
+            uint64_t shingle = hasher(std::string_view(padded).substr(i, SHINGLE_LENGTH));
+            for (size_t k = 0; k < SIGNATURE_LENGTH; ++k) {
+                signature[k] = std::min(signature[k], combine_hash(k + 1, shingle));
+            }
+        }
+        return signature;
+    }
+
+    // Normalised names within an edit distance of 40% of the longer one
+    bool similar_names(const std::string& a, const std::string& b) {
+        int max_distance = static_cast<int>(std::max(a.size(), b.size()) * 2 / 5);
+        return EntityResolver::bounded_edit_distance(a, b, max_distance) <= max_distance;
+    }
+
+    bool contains(const std::vector<std::string>& values, const std::string& value) {
+        return value.empty() || std::find(values.begin(), values.end(), value) != values.end();
+    }
+    // Folds each record into its group's earliest member, in input order, and
+    // compacts the survivors. Returns the number of records merged away.
+    size_t merge_groups(std::vector<Business>& businesses, DisjointSet& groups) {
+        const size_t count = businesses.size();
+        std::vector<bool> merged(count, false);
+        size_t merged_count = 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t root = groups.find(i);
+            if (root != i) {
+                EntityResolver::merge_into(businesses[root], businesses[i]);
+                merged[i] = true;
+                merged_count++;
+            }
+        }
+
+        if (merged_count > 0) {
+            size_t out = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (!merged[i]) {
+                    if (out != i) {
+                        businesses[out] = std::move(businesses[i]);
+                    }
+                    out++;
+                }
+            }
+            businesses.resize(out);
+        }
+
+        return merged_count;
+    }
+} // end anonymous namespace
+
+EntityResolver::EntityResolver() {}
+
+EntityResolver::~EntityResolver() {}
+
+size_t EntityResolver::resolve(std::vector<Business>& businesses) const {
+    const size_t count = businesses.size();
+    DisjointSet groups(count);
+
+    // Keys are indexed by 64-bit hash; the first record seen with a key owns it
+    KeyIndex index(count * 4);
+
+    auto link = [&](uint64_t key, size_t record) {
+        size_t owner = index.claim(key, record);
+        if (owner != record) {
+            groups.unite(owner, record);
+        }
+    };
+
+    std::hash<std::string> hasher;
+    for (size_t i = 0; i < count; ++i) {
+        const Business& business = businesses[i];
+        std::string phone = normalize_phone(business.phone_number());
+        std::string domain = normalize_domain(business.website());
+        std::string address = normalize_address(business.address());
+
+        // Key kinds are salted so values from different fields never collide
+        uint64_t phone_hash = phone.empty() ? 0 : hasher(phone);
+        uint64_t domain_hash = domain.empty() ? 0 : hasher(domain);
+        uint64_t address_hash = address.empty() ? 0 : hasher(address);
+
+        if (!business.place_id().empty()) {
+            link(combine_hash(1, hasher(business.place_id())), i);
+        }
+        if (phone_hash && address_hash) {
+            link(combine_hash(combine_hash(2, phone_hash), address_hash), i);
+        }
+        if (phone_hash && domain_hash) {
+            link(combine_hash(combine_hash(3, phone_hash), domain_hash), i);
+        }
+        if (domain_hash && address_hash) {
+            link(combine_hash(combine_hash(4, domain_hash), address_hash), i);
+        }
+    }
+
+    return merge_groups(businesses, groups);
+}
+
+size_t EntityResolver::resolve_similar_names(std::vector<Business>& businesses) const {
+    const size_t count = businesses.size();
+    DisjointSet groups(count);
+
+    std::vector<std::string> names(count);
+    std::vector<std::pair<uint64_t, size_t>> buckets;
+    buckets.reserve(count * BANDS * 2);
+
+    std::hash<std::string> hasher;
+    for (size_t i = 0; i < count; ++i) {
+        names[i] = normalize_name(businesses[i].name());
+        if (names[i].empty()) continue;
+
+        // Only records at the same place can be the same business, so each LSH
+        // band is keyed together with the address or phone. This keeps buckets
+        // small and turns every candidate pair into one worth checking.
+        std::string address = normalize_address(businesses[i].address());
+        std::string phone = normalize_phone(businesses[i].phone_number());
+        uint64_t locations[2] = {
+            address.empty() ? 0 : combine_hash(1, hasher(address)),
+            phone.empty() ? 0 : combine_hash(2, hasher(phone))
+        };
+        if (!locations[0] && !locations[1]) continue;
+
+        std::array<uint64_t, SIGNATURE_LENGTH> signature = minhash_signature(names[i]);
+        for (size_t band = 0; band < BANDS; ++band) {
+            uint64_t band_hash = band;
+            for (size_t row = 0; row < BAND_ROWS; ++row) {
+                band_hash = combine_hash(band_hash, signature[band * BAND_ROWS + row]);
+            }
+            for (uint64_t location : locations) {
+                if (location) {
+                    buckets.emplace_back(combine_hash(band_hash, location), i);
+                }
+            }
+        }
+    }
+
+    // Records sharing a bucket are candidate pairs; confirm each by edit distance
+    std::sort(buckets.begin(), buckets.end());
+    for (size_t start = 0; start < buckets.size();) {
+        size_t end = start + 1;
+        while (end < buckets.size() && buckets[end].first == buckets[start].first) {
+            end++;
+        }
+        for (size_t a = start; a < end; ++a) {
+            for (size_t b = a + 1; b < end; ++b) {
+                size_t first = buckets[a].second;
+                size_t second = buckets[b].second;
+                if (first == second || groups.find(first) == groups.find(second)) continue;
+
+                if (similar_names(names[first], names[second])) {
+                    groups.unite(first, second);
+                }
+            }
+        }
+        start = end;
+    }
+
+    return merge_groups(businesses, groups);
+}
+
+size_t EntityResolver::resolve_nearby(std::vector<Business>& businesses, double max_distance_meters) const {
+    const size_t count = businesses.size();
+    DisjointSet groups(count);
+
+    GeoIndex index;
+    index.build(businesses);
+    if (index.empty()) {
+        return 0;
+    }
+
+    std::vector<std::string> names(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (businesses[i].has_coordinates()) {
+            names[i] = normalize_name(businesses[i].name());
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (names[i].empty()) continue;
+
+        GeoPoint center{businesses[i].latitude(), businesses[i].longitude()};
+        for (size_t j : index.query_radius(center, max_distance_meters)) {
+            if (j <= i || names[j].empty() || groups.find(i) == groups.find(j)) continue;
+            if (similar_names(names[i], names[j])) {
+                groups.unite(i, j);
+            }
+        }
+    }
+
+    return merge_groups(businesses, groups);
+}
+
+void EntityResolver::merge_into(Business& target, const Business& source) {
+    if (target.place_id().empty()) target.set_place_id(source.place_id());
+    if (target.name().empty()) target.set_name(source.name());
+    if (target.address().empty()) target.set_address(source.address());
+    if (target.website().empty()) target.set_website(source.website());
+    if (!target.has_coordinates() && source.has_coordinates()) {
+        target.set_coordinates(source.latitude(), source.longitude());
+    }
+
+    // Keep the rating backed by more reviews
+    if (source.total_ratings() > target.total_ratings()) {
+        target.set_rating(source.rating());
+        target.set_total_ratings(source.total_ratings());
+    }
+
+    const std::string& phone = source.phone_number();
+    if (target.phone_number().empty()) {
+        target.set_phone_number(phone);
+    } else if (!phone.empty() && phone != target.phone_number() &&
+               normalize_phone(phone) != normalize_phone(target.phone_number()) &&
+               !contains(target.additional_numbers(), phone)) {
+        target.add_additional_number(phone);
+    }
+    for (const auto& number : source.additional_numbers()) {
+        if (number != target.phone_number() && !contains(target.additional_numbers(), number)) {
+            target.add_additional_number(number);
+        }
+    }
+
+    const std::string& email = source.email();
+    if (target.email().empty()) {
+        target.set_email(email);
+    } else if (!email.empty() && email != target.email() && !contains(target.additional_emails(), email)) {
+        target.add_additional_email(email);
+    }
+    for (const auto& additional : source.additional_emails()) {
+        if (additional != target.email() && !contains(target.additional_emails(), additional)) {
+            target.add_additional_email(additional);
+        }
+    }
+
+    for (const auto& link : source.social_media_links()) {
+        if (!contains(target.social_media_links(), link)) {
+            target.add_social_link(link);
+        }
+    }
+}
+
+std::string EntityResolver::normalize_name(std::string_view name) {
+    // Lowercase words with apostrophes dropped ("Joe’s" and "Joe's" become "joes")
+    std::string normalized;
+    normalized.reserve(name.size());
+    std::string word;
+
+    auto flush_word = [&]() {
+        if (word.empty()) return;
+        if (std::find(std::begin(NAME_STOP_WORDS), std::end(NAME_STOP_WORDS), word) == std::end(NAME_STOP_WORDS)) {
+            if (!normalized.empty()) normalized += ' ';
+            normalized += word;
+        }
+        word.clear();
+    };
+
+    for (size_t i = 0; i < name.size(); ++i) {
+        unsigned char byte = static_cast<unsigned char>(name[i]);
+        if (byte == '\'' || byte == '`') continue;
+        if (name.compare(i, 3, "\xE2\x80\x99") == 0) {  // U+2019 right single quotation mark
+            i += 2;
+            continue;
+        }
+        if (std::isalnum(byte) || byte >= 0x80) {
+            word += static_cast<char>(std::tolower(byte));
+        } else {
+            flush_word();
+        }
+    }
+    flush_word();
+
+    return normalized;
+}
+
+int EntityResolver::bounded_edit_distance(std::string_view a, std::string_view b, int max_distance) {
+    if (a.size() > b.size()) std::swap(a, b);
+    const int n = static_cast<int>(a.size());
+    const int m = static_cast<int>(b.size());
+    if (max_distance < 0 || m - n > max_distance) return max_distance + 1;
+
+    // Levenshtein restricted to the diagonal band |i - j| <= max_distance;
+    // cells outside the band are treated as already over the limit
+    const int over = max_distance + 1;
+    std::vector<int> previous(m + 1, over);
+    std::vector<int> current(m + 1, over);
+    for (int j = 0; j <= std::min(m, max_distance); ++j) {
+        previous[j] = j;
+    }
+
+    for (int i = 1; i <= n; ++i) {
+        int low = std::max(1, i - max_distance);
+        int high = std::min(m, i + max_distance);
+        current[low - 1] = (low == 1 && i <= max_distance) ? i : over;
+        if (high < m) current[high + 1] = over;
+
+        int row_min = current[low - 1];
+        for (int j = low; j <= high; ++j) {
+            int cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+            int value = std::min({previous[j - 1] + cost, previous[j] + 1, current[j - 1] + 1});
+            current[j] = std::min(value, over);
+            row_min = std::min(row_min, current[j]);
+        }
+        if (row_min > max_distance) return over;
+        std::swap(previous, current);
+    }
+
+    return std::min(previous[m], over);
+}
+
+std::string EntityResolver::normalize_phone(std::string_view phone) {
+    std::string digits;
+    digits.reserve(phone.size());
+    for (char c : phone) {
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            digits += c;
+        }
+    }
+
+    // Drop the North American country code so +1 and local forms agree
+    if (digits.length() == 11 && digits[0] == '1') {
+        digits.erase(0, 1);
+    }
+
+    // Too short to identify a line
+    if (digits.length() < 7) {
+        digits.clear();
+    }
+    return digits;
+}
+
+std::string EntityResolver::normalize_domain(std::string_view website) {
+    size_t start = website.find("://");
+    start = (start == std::string_view::npos) ? 0 : start + 3;
+    size_t end = website.find_first_of(":/?#", start);
+    std::string_view host = website.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+
+    std::string domain;
+    domain.reserve(host.size());
+    for (char c : host) {
+        domain += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (domain.compare(0, 4, "www.") == 0) {
+        domain.erase(0, 4);
+    }
+    while (!domain.empty() && domain.back() == '.') {
+        domain.pop_back();
+    }
+
+    for (const char* shared : SHARED_HOSTS) {
+        std::string_view suffix(shared);
+        if (domain == suffix ||
+            (domain.size() > suffix.size() && domain.compare(domain.size() - suffix.size(), suffix.size(), suffix) == 0 &&
+             domain[domain.size() - suffix.size() - 1] == '.')) {
+            return "";
+        }
+    }
+    return domain;
+}
+
+std::string EntityResolver::normalize_address(std::string_view address) {
+    // Lowercase alphanumeric words, abbreviated, joined by single spaces
+    std::string normalized;
+    normalized.reserve(address.size());
+    std::string word;
+
+    auto flush_word = [&]() {
+        if (word.empty()) return;
+        for (const auto& abbreviation : ADDRESS_ABBREVIATIONS) {
+            if (word == abbreviation.first) {
+                word = abbreviation.second;
+                break;
+            }
+        }
+        if (!normalized.empty()) normalized += ' ';
+        normalized += word;
+        word.clear();
+    };
+
+    for (char c : address) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (std::isalnum(byte) || byte >= 0x80) {
+            word += static_cast<char>(std::tolower(byte));
+        } else {
+            flush_word();
+        }
+    }
+    flush_word();
+
+    return normalized;
+}
@@ -0,0 +1,174 @@
+#include "core/GeoIndex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr double EARTH_RADIUS_METERS = 6371008.8;
+    constexpr double PI = 3.14159265358979323846;
+
+    double to_radians(double degrees) { return degrees * PI / 180.0; }
+    double to_degrees(double radians) { return radians * 180.0 / PI; }
+
+    // Maps any longitude into [-180, 180)
+    double wrap_longitude(double longitude) {
+        double wrapped = std::fmod(longitude + 180.0, 360.0);
+        if (wrapped < 0.0) wrapped += 360.0;
+        return wrapped - 180.0;
+    }
+
+    // Haversine term: sin^2(dlat/2) + cos(lat1) cos(lat2) sin^2(dlng/2).
+    // Monotonic in distance, so radius tests compare it without the arcsine.
+    double haversine(double latitude_a, double longitude_a, double cos_latitude_a,
+                     double latitude_b, double longitude_b, double cos_latitude_b) {
+        double half_dlat = std::sin(to_radians(latitude_b - latitude_a) / 2.0);
+        double half_dlng = std::sin(to_radians(longitude_b - longitude_a) / 2.0);
+        return half_dlat * half_dlat + cos_latitude_a * cos_latitude_b * half_dlng * half_dlng;
+    }
+}
+
+GeoIndex::GeoIndex(double cell_degrees)
+    : m_cell_degrees(cell_degrees > 0.0 ? cell_degrees : DEFAULT_CELL_DEGREES)
+    , m_column_count(static_cast<int32_t>(std::ceil(360.0 / m_cell_degrees)))
+{}
+
+GeoIndex::~GeoIndex() {}
+
+template <typename Visitor>
+void GeoIndex::scan_cells(double south, double west, double north, double east, Visitor&& visit) const {
+    if (m_entries.empty() || south > north) return;
+
+    const int32_t first_row = row_of(std::max(south, -90.0));
+    const int32_t last_row = row_of(std::min(north, 90.0));
+
+    // A rectangle crossing the antimeridian covers two column ranges
+    std::pair<int32_t, int32_t> ranges[2];
+    size_t range_count = 0;
+    int32_t west_column = column_of(west);
+    int32_t east_column = column_of(east);
+    if (west <= east && west_column <= east_column) {
+        ranges[range_count++] = {west_column, east_column};
+    } else {
+        ranges[range_count++] = {west_column, m_column_count - 1};
+        ranges[range_count++] = {0, east_column};
+    }
+
+    auto by_cell = [](const Entry& entry, uint64_t cell) { return entry.cell < cell; };
+    for (int32_t row = first_row; row <= last_row; ++row) {
+        for (size_t r = 0; r < range_count; ++r) {
+            uint64_t first_cell = cell_key(row, ranges[r].first);
+            uint64_t last_cell = cell_key(row, ranges[r].second);
+            auto it = std::lower_bound(m_entries.begin(), m_entries.end(), first_cell, by_cell);
+            for (; it != m_entries.end() && it->cell <= last_cell; ++it) {
+                visit(*it);
+            }
+        }
+    }
+}
+
+template <typename Visitor>
+void GeoIndex::visit_radius(const GeoPoint& center, double radius_meters, Visitor&& visit) const {
+    if (radius_meters < 0.0) return;
+
+    const double angle = radius_meters / EARTH_RADIUS_METERS;
+    const double center_latitude = std::clamp(center.latitude, -90.0, 90.0);
+    const double center_longitude = wrap_longitude(center.longitude);
+    const double center_cos = std::cos(to_radians(center_latitude));
+    const double half_angle_sin = std::sin(std::min(angle, PI) / 2.0);
+    const double threshold = half_angle_sin * half_angle_sin;
+
+    // Bounding rectangle of the circle; it spans every longitude when the
+    // circle reaches a pole
+    const double latitude_span = to_degrees(angle);
+    const double south = center_latitude - latitude_span;
+    const double north = center_latitude + latitude_span;
+    double west = -180.0;
+    double east = 180.0;
+    double sin_ratio = std::sin(std::min(angle, PI / 2.0)) / center_cos;
+    if (south > -90.0 && north < 90.0 && sin_ratio < 1.0) {
+        double longitude_span = to_degrees(std::asin(sin_ratio));
+        west = center_longitude - longitude_span;
+        east = center_longitude + longitude_span;
+        if (west < -180.0) west += 360.0;
+        if (east > 180.0) east -= 360.0;
+    }
+
+    scan_cells(south, west, north, east, [&](const Entry& entry) {
+        if (haversine(center_latitude, center_longitude, center_cos,
+                      entry.latitude, entry.longitude, entry.cos_latitude) <= threshold) {
+            visit(entry);
+        }
+    });
+}
+
+void GeoIndex::build(const std::vector<Business>& businesses) {
+    m_entries.clear();
+    m_entries.reserve(businesses.size());
+
+    for (size_t i = 0; i < businesses.size(); ++i) {
+        const Business& business = businesses[i];
+        if (!business.has_coordinates()) continue;
+
+        Entry entry;
+        entry.latitude = std::clamp(business.latitude(), -90.0, 90.0);
+        entry.longitude = wrap_longitude(business.longitude());
+        entry.cos_latitude = std::cos(to_radians(entry.latitude));
+        entry.record = static_cast<uint32_t>(i);
+        entry.cell = cell_key(row_of(entry.latitude), column_of(entry.longitude));
+        m_entries.push_back(entry);
+    }
+
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.cell != b.cell ? a.cell < b.cell : a.record < b.record;
+    });
+}
+
+std::vector<size_t> GeoIndex::query_radius(const GeoPoint& center, double radius_meters) const {
+    std::vector<size_t> records;
+    visit_radius(center, radius_meters, [&](const Entry& entry) { records.push_back(entry.record); });
+    std::sort(records.begin(), records.end());
+    return records;
+}
+
+size_t GeoIndex::count_radius(const GeoPoint& center, double radius_meters) const {
+    size_t count = 0;
+    visit_radius(center, radius_meters, [&](const Entry&) { count++; });
+    return count;
+}
+
+std::vector<size_t> GeoIndex::query_bounds(const GeoBounds& bounds) const {
+    std::vector<size_t> records;
+    const bool wraps = bounds.west > bounds.east;
+
+    scan_cells(bounds.south, bounds.west, bounds.north, bounds.east, [&](const Entry& entry) {
+        if (entry.latitude < bounds.south || entry.latitude > bounds.north) return;
+        bool inside = wraps ? (entry.longitude >= bounds.west || entry.longitude <= bounds.east)
+                            : (entry.longitude >= bounds.west && entry.longitude <= bounds.east);
+        if (inside) {
+            records.push_back(entry.record);
+        }
+    });
+
+    std::sort(records.begin(), records.end());
+    return records;
+}
+
+double GeoIndex::distance_meters(const GeoPoint& a, const GeoPoint& b) {
+    double h = haversine(a.latitude, a.longitude, std::cos(to_radians(a.latitude)),
+                         b.latitude, b.longitude, std::cos(to_radians(b.latitude)));
+    return 2.0 * EARTH_RADIUS_METERS * std::asin(std::sqrt(std::min(1.0, h)));
+}
+
+uint64_t GeoIndex::cell_key(int32_t row, int32_t column) const {
+    return (static_cast<uint64_t>(row) << 32) | static_cast<uint32_t>(column);
+}
+
+int32_t GeoIndex::row_of(double latitude) const {
+    int32_t row_count = static_cast<int32_t>(std::ceil(180.0 / m_cell_degrees));
+    int32_t row = static_cast<int32_t>(std::floor((latitude + 90.0) / m_cell_degrees));
+    return std::clamp(row, 0, row_count - 1);
+}
+
+int32_t GeoIndex::column_of(double longitude) const {
+    int32_t column = static_cast<int32_t>(std::floor((longitude + 180.0) / m_cell_degrees));
+    return std::clamp(column, 0, m_column_count - 1);
+}
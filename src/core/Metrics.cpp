@@ -0,0 +1,239 @@
+#include "core/Metrics.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace {
+    // Upper bucket bounds shared by every histogram, in milliseconds
+    const std::vector<double>& bucket_bounds() {
+        static const std::vector<double> bounds = {
+            1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000
+        };
+        return bounds;
+    }
+
+    // Same escaping rules for JSON strings and Prometheus label values
+    std::string escape_string(const std::string& str) {
+        std::string escaped;
+        for (char c : str) {
+            switch (c) {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                default: escaped += c; break;
+            }
+        }
+        return escaped;
+    }
+
+    std::string label_text(const std::string& key, const std::string& value, const std::string& extra = "") {
+        std::string labels;
+        if (!value.empty()) {
+            labels = key + "=\"" + escape_string(value) + "\"";
+        }
+        if (!extra.empty()) {
+            labels += (labels.empty() ? "" : ",") + extra;
+        }
+        return labels.empty() ? "" : "{" + labels + "}";
+    }
+} // end anonymous namespace
+
+double HistogramSample::percentile_ms(double percentile) const {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    // Upper bound of the bucket holding the requested rank
+    const uint64_t rank = static_cast<uint64_t>(std::max(1.0, percentile / 100.0 * count));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucket_counts.size(); ++i) {
+        seen += bucket_counts[i];
+        if (seen >= rank) {
+            return i < bucket_bounds_ms.size() ? std::min(bucket_bounds_ms[i], max_ms) : max_ms;
+        }
+    }
+    return max_ms;
+}
+
+uint64_t MetricsSnapshot::counter(const std::string& name, const std::string& label) const {
+    uint64_t total = 0;
+    for (const auto& sample : counters) {
+        if (sample.name == name && (label.empty() || sample.label == label)) {
+            total += sample.value;
+        }
+    }
+    return total;
+}
+
+const HistogramSample* MetricsSnapshot::histogram(const std::string& name, const std::string& label) const {
+    for (const auto& sample : histograms) {
+        if (sample.name == name && sample.label == label) {
+            return &sample;
+        }
+    }
+    return nullptr;
+}
+
+std::string MetricsSnapshot::to_json() const {
+    std::ostringstream oss;
+
+    oss << "{\n  \"counters\": [";
+    for (size_t i = 0; i < counters.size(); ++i) {
+        const auto& sample = counters[i];
+        oss << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": \"" << escape_string(sample.name) << "\", "
+            << "\"type\": \"" << escape_string(sample.label) << "\", "
+            << "\"value\": " << sample.value << "}";
+    }
+    oss << (counters.empty() ? "],\n" : "\n  ],\n");
+
+    oss << "  \"latency_ms\": [";
+    for (size_t i = 0; i < histograms.size(); ++i) {
+        const auto& sample = histograms[i];
+        oss << (i == 0 ? "\n" : ",\n")
+            << "    {\"stage\": \"" << escape_string(sample.name) << "\", "
+            << "\"host\": \"" << escape_string(sample.label) << "\", "
+            << "\"count\": " << sample.count << ", "
+            << std::fixed << std::setprecision(3)
+            << "\"sum\": " << sample.sum_ms << ", "
+            << "\"mean\": " << sample.mean_ms() << ", "
+            << "\"p50\": " << sample.percentile_ms(50) << ", "
+            << "\"p90\": " << sample.percentile_ms(90) << ", "
+            << "\"p99\": " << sample.percentile_ms(99) << ", "
+            << "\"max\": " << sample.max_ms << ", "
+            << std::defaultfloat << std::setprecision(6)
+            << "\"buckets\": [";
+        for (size_t j = 0; j < sample.bucket_counts.size(); ++j) {
+            if (j > 0) oss << ", ";
+            oss << "{\"le\": ";
+            if (j < sample.bucket_bounds_ms.size()) {
+                oss << sample.bucket_bounds_ms[j];
+            } else {
+                oss << "\"+Inf\"";
+            }
+            oss << ", \"count\": " << sample.bucket_counts[j] << "}";
+        }
+        oss << "]}";
+    }
+    oss << (histograms.empty() ? "]\n" : "\n  ]\n");
+    oss << "}\n";
+
+    return oss.str();
+}
+
+std::string MetricsSnapshot::to_prometheus() const {
+    std::ostringstream oss;
+    std::string last_name;
+
+    for (const auto& sample : counters) {
+        const std::string name = "business_scraper_" + sample.name + "_total";
+        if (name != last_name) {
+            oss << "# TYPE " << name << " counter\n";
+            last_name = name;
+        }
+        oss << name << label_text("type", sample.label) << " " << sample.value << "\n";
+    }
+
+    // Prometheus convention is seconds, cumulative buckets
+    for (const auto& sample : histograms) {
+        const std::string name = "business_scraper_" + sample.name + "_seconds";
+        if (name != last_name) {
+            oss << "# TYPE " << name << " histogram\n";
+            last_name = name;
+        }
+
+        uint64_t cumulative = 0;
+        for (size_t j = 0; j < sample.bucket_counts.size(); ++j) {
+            cumulative += sample.bucket_counts[j];
+            std::ostringstream bound;
+            if (j < sample.bucket_bounds_ms.size()) {
+                bound << sample.bucket_bounds_ms[j] / 1000.0;
+            } else {
+                bound << "+Inf";
+            }
+            oss << name << "_bucket" << label_text("host", sample.label, "le=\"" + bound.str() + "\"")
+                << " " << cumulative << "\n";
+        }
+        oss << name << "_sum" << label_text("host", sample.label) << " " << sample.sum_ms / 1000.0 << "\n";
+        oss << name << "_count" << label_text("host", sample.label) << " " << sample.count << "\n";
+    }
+
+    return oss.str();
+}
+
+MetricsRegistry::MetricsRegistry() {}
+
+MetricsRegistry::~MetricsRegistry() {}
+
+void MetricsRegistry::increment(const std::string& name, const std::string& label, uint64_t amount) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters[Key(name, label)] += amount;
+}
+
+void MetricsRegistry::record_latency(const std::string& stage, double milliseconds, const std::string& host) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    observe(m_histograms[Key(stage, "")], milliseconds);
+    if (!host.empty()) {
+        observe(m_histograms[Key(stage, host)], milliseconds);
+    }
+}
+
+void MetricsRegistry::observe(Histogram& histogram, double milliseconds) {
+    const auto& bounds = bucket_bounds();
+    if (histogram.bucket_counts.empty()) {
+        histogram.bucket_counts.assign(bounds.size() + 1, 0);
+    }
+
+    size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), milliseconds) - bounds.begin();
+    histogram.bucket_counts[bucket]++;
+    histogram.count++;
+    histogram.sum_ms += milliseconds;
+    histogram.max_ms = std::max(histogram.max_ms, milliseconds);
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    MetricsSnapshot snapshot;
+
+    for (const auto& entry : m_counters) {
+        CounterSample sample;
+        sample.name = entry.first.first;
+        sample.label = entry.first.second;
+        sample.value = entry.second;
+        snapshot.counters.push_back(sample);
+    }
+
+    for (const auto& entry : m_histograms) {
+        HistogramSample sample;
+        sample.name = entry.first.first;
+        sample.label = entry.first.second;
+        sample.bucket_bounds_ms = bucket_bounds();
+        sample.bucket_counts = entry.second.bucket_counts;
+        sample.count = entry.second.count;
+        sample.sum_ms = entry.second.sum_ms;
+        sample.max_ms = entry.second.max_ms;
+        snapshot.histograms.push_back(sample);
+    }
+
+    return snapshot;
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters.clear();
+    m_histograms.clear();
+}
+
+ScopedLatency::ScopedLatency(MetricsRegistry* registry, const std::string& stage, const std::string& host)
+    : m_registry(registry)
+    , m_stage(registry ? stage : std::string())
+    , m_host(registry ? host : std::string())
+    , m_start(std::chrono::steady_clock::now())
+{}
+
+ScopedLatency::~ScopedLatency() {
+    if (m_registry) {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_registry->record_latency(m_stage, std::chrono::duration<double, std::milli>(elapsed).count(), m_host);
+    }
+}
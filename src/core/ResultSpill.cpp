@@ -0,0 +1,219 @@
+#include "core/ResultSpill.h"
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+namespace {
+    // Records are stored as length-prefixed fields in native byte order; the
+    // spill file is private to one run so it never needs to be portable
+    void write_string(std::ostream& out, const std::string& value) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(value.data(), length);
+    }
+
+    void write_strings(std::ostream& out, const std::vector<std::string>& values) {
+        uint32_t count = static_cast<uint32_t>(values.size());
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const auto& value : values) {
+            write_string(out, value);
+        }
+    }
+
+    bool read_string(std::istream& in, std::string& value) {
+        uint32_t length = 0;
+        if (!in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+            return false;
+        }
+        value.resize(length);
+        return static_cast<bool>(in.read(&value[0], length));
+    }
+
+    bool read_strings(std::istream& in, std::vector<std::string>& values) {
+        uint32_t count = 0;
+        if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+            return false;
+        }
+        values.resize(count);
+        for (auto& value : values) {
+            if (!read_string(in, value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void write_business(std::ostream& out, const Business& business) {
+        write_string(out, business.place_id());
+        write_string(out, business.name());
+        write_string(out, business.address());
+        write_string(out, business.phone_number());
+        write_string(out, business.email());
+        write_string(out, business.website());
+
+        double rating = business.rating();
+        int32_t total_ratings = business.total_ratings();
+        out.write(reinterpret_cast<const char*>(&rating), sizeof(rating));
+        out.write(reinterpret_cast<const char*>(&total_ratings), sizeof(total_ratings));
+
+        double latitude = business.latitude();
+        double longitude = business.longitude();
+        out.write(reinterpret_cast<const char*>(&latitude), sizeof(latitude));
+        out.write(reinterpret_cast<const char*>(&longitude), sizeof(longitude));
+
+        int64_t fetched_at = business.fetched_at();
+        out.write(reinterpret_cast<const char*>(&fetched_at), sizeof(fetched_at));
+
+        write_strings(out, business.additional_numbers());
+        write_strings(out, business.additional_emails());
+        write_strings(out, business.social_media_links());
+    }
+
+    bool read_business(std::istream& in, Business& business) {
+        std::string value;
+        std::vector<std::string> values;
+        double rating = 0.0;
+        int32_t total_ratings = 0;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        int64_t fetched_at = 0;
+
+        if (!read_string(in, value)) return false;
+        business.set_place_id(std::move(value));
+        if (!read_string(in, value)) return false;
+        business.set_name(std::move(value));
+        if (!read_string(in, value)) return false;
+        business.set_address(std::move(value));
+        if (!read_string(in, value)) return false;
+        business.set_phone_number(std::move(value));
+        if (!read_string(in, value)) return false;
+        business.set_email(std::move(value));
+        if (!read_string(in, value)) return false;
+        business.set_website(std::move(value));
+
+        if (!in.read(reinterpret_cast<char*>(&rating), sizeof(rating))) return false;
+        if (!in.read(reinterpret_cast<char*>(&total_ratings), sizeof(total_ratings))) return false;
+        business.set_rating(rating);
+        business.set_total_ratings(total_ratings);
+
+        if (!in.read(reinterpret_cast<char*>(&latitude), sizeof(latitude))) return false;
+        if (!in.read(reinterpret_cast<char*>(&longitude), sizeof(longitude))) return false;
+        business.set_coordinates(latitude, longitude);
+
+        if (!in.read(reinterpret_cast<char*>(&fetched_at), sizeof(fetched_at))) return false;
+        business.set_fetched_at(fetched_at);
+
+        if (!read_strings(in, values)) return false;
+        business.set_additional_numbers(std::move(values));
+        if (!read_strings(in, values)) return false;
+        business.set_additional_emails(std::move(values));
+        if (!read_strings(in, values)) return false;
+        business.set_social_media_links(std::move(values));
+
+        return true;
+    }
+
+    size_t strings_size(const std::vector<std::string>& values) {
+        size_t size = values.capacity() * sizeof(std::string);
+        for (const auto& value : values) {
+            size += value.capacity();
+        }
+        return size;
+    }
+} // end anonymous namespace
+
+ResultSpill::ResultSpill(const std::string& filename, size_t memory_budget_bytes)
+    : m_filename(filename)
+    , m_memory_budget(memory_budget_bytes)
+    , m_buffered_bytes(0)
+    , m_count(0)
+    , m_spilled_count(0)
+{
+    m_file.open(m_filename, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        m_last_error = "Could not create spill file: " + m_filename;
+    }
+}
+
+ResultSpill::~ResultSpill() {
+    m_file.close();
+    std::remove(m_filename.c_str());
+}
+
+void ResultSpill::append(Business business) {
+    size_t size = estimated_size(business);
+
+    // Without a usable file everything stays in memory rather than being lost
+    if (m_file.is_open() && !m_buffer.empty() && m_buffered_bytes + size > m_memory_budget) {
+        flush_buffer();
+    }
+
+    m_buffer.push_back(std::move(business));
+    m_buffered_bytes += size;
+    m_count++;
+}
+
+bool ResultSpill::for_each(const std::function<void(const Business&)>& callback) {
+    if (m_spilled_count > 0) {
+        if (m_file.is_open()) {
+            m_file.flush();
+        }
+
+        std::ifstream in(m_filename, std::ios::binary);
+        if (!in.is_open()) {
+            m_last_error = "Could not read spill file: " + m_filename;
+            return false;
+        }
+
+        // Only one spilled record is resident at a time. Reading exactly the
+        // records that were written skips any tail left by a failed write and
+        // reports a file that was cut short.
+        Business business;
+        for (size_t i = 0; i < m_spilled_count; ++i) {
+            if (!read_business(in, business)) {
+                m_last_error = "Spill file is corrupt: " + m_filename;
+                return false;
+            }
+            callback(business);
+        }
+    }
+
+    for (const auto& business : m_buffer) {
+        callback(business);
+    }
+
+    return true;
+}
+
+void ResultSpill::flush_buffer() {
+    for (const auto& business : m_buffer) {
+        write_business(m_file, business);
+    }
+    m_file.flush();
+
+    if (!m_file) {
+        // Keep the buffer and stop spilling; the records written before stay readable
+        m_last_error = "Error writing spill file: " + m_filename + "; keeping results in memory";
+        m_file.close();
+        return;
+    }
+
+    m_spilled_count += m_buffer.size();
+
+    // Release the buffer's storage, not just its elements
+    std::vector<Business>().swap(m_buffer);
+    m_buffered_bytes = 0;
+}
+
+size_t ResultSpill::estimated_size(const Business& business) {
+    return sizeof(Business) +
+           business.place_id().capacity() +
+           business.name().capacity() +
+           business.address().capacity() +
+           business.phone_number().capacity() +
+           business.email().capacity() +
+           business.website().capacity() +
+           strings_size(business.additional_numbers()) +
+           strings_size(business.additional_emails()) +
+           strings_size(business.social_media_links());
+}
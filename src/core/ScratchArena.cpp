@@ -0,0 +1,8 @@
+#include "core/ScratchArena.h"
+
+ScratchArena::ScratchArena(size_t initial_bytes)
+    : m_initial_block(new char[initial_bytes])
+    , m_resource(m_initial_block.get(), initial_bytes, std::pmr::new_delete_resource())
+{}
+
+ScratchArena::~ScratchArena() {}
@@ -0,0 +1,188 @@
+#include "core/Trace.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    struct TraceEvent {
+        const char* name;
+        int64_t start_us;
+        int64_t duration_us;
+    };
+
+    // Single-producer event buffer owned by one thread. Events are written into
+    // fixed chunks that never move, and the count is published with release
+    // ordering, so the writer can read without taking a lock.
+    class ThreadBuffer {
+    public:
+        static constexpr size_t CHUNK_SIZE = 4096;
+        static constexpr size_t MAX_CHUNKS = 1024;
+
+        explicit ThreadBuffer(int thread_index)
+            : m_thread_index(thread_index)
+            , m_count(0)
+        {
+            for (auto& chunk : m_chunks) {
+                chunk.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~ThreadBuffer() {
+            for (auto& chunk : m_chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        void push(const TraceEvent& event) {
+            size_t index = m_count.load(std::memory_order_relaxed);
+            size_t chunk_index = index / CHUNK_SIZE;
+            if (chunk_index >= MAX_CHUNKS) {
+                return; // Buffer full: drop rather than block
+            }
+
+            TraceEvent* chunk = m_chunks[chunk_index].load(std::memory_order_relaxed);
+            if (!chunk) {
+                chunk = new TraceEvent[CHUNK_SIZE];
+                m_chunks[chunk_index].store(chunk, std::memory_order_release);
+            }
+
+            chunk[index % CHUNK_SIZE] = event;
+            m_count.store(index + 1, std::memory_order_release);
+        }
+
+        size_t size() const { return m_count.load(std::memory_order_acquire); }
+
+        const TraceEvent& at(size_t index) const {
+            return m_chunks[index / CHUNK_SIZE].load(std::memory_order_acquire)[index % CHUNK_SIZE];
+        }
+
+        int thread_index() const { return m_thread_index; }
+
+    private:
+        int m_thread_index;
+        std::atomic<size_t> m_count;
+        std::atomic<TraceEvent*> m_chunks[MAX_CHUNKS];
+    };
+
+    // Buffers outlive their threads so worker spans survive until export
+    struct TraceState {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::atomic<bool> recording{false};
+        std::string last_error;
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+
+    TraceState& state() {
+        static TraceState trace_state;
+        return trace_state;
+    }
+
+    ThreadBuffer* thread_buffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            TraceState& trace_state = state();
+            std::lock_guard<std::mutex> lock(trace_state.mutex);
+            int index = static_cast<int>(trace_state.buffers.size()) + 1;
+            trace_state.buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer(index)));
+            buffer = trace_state.buffers.back().get();
+        }
+        return buffer;
+    }
+
+    void write_json_string(std::ostream& out, const char* str) {
+        out << '"';
+        for (const char* c = str; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out << '\\';
+            }
+            out << *c;
+        }
+        out << '"';
+    }
+} // end anonymous namespace
+
+bool Tracer::is_compiled_in() {
+#ifdef BUSINESS_SCRAPER_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Tracer::start() {
+    if (is_compiled_in()) {
+        state().recording.store(true, std::memory_order_relaxed);
+    }
+}
+
+void Tracer::stop() {
+    state().recording.store(false, std::memory_order_relaxed);
+}
+
+bool Tracer::is_recording() {
+    return state().recording.load(std::memory_order_relaxed);
+}
+
+int64_t Tracer::now_us() {
+    auto elapsed = std::chrono::steady_clock::now() - state().epoch;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void Tracer::record(const char* name, int64_t start_us, int64_t duration_us) {
+    thread_buffer()->push(TraceEvent{name, start_us, duration_us});
+}
+
+bool Tracer::write_chrome_trace(const std::string& filename) {
+    TraceState& trace_state = state();
+    std::lock_guard<std::mutex> lock(trace_state.mutex);
+    trace_state.last_error.clear();
+
+    if (!is_compiled_in()) {
+        trace_state.last_error = "Tracing was not compiled in (build with BUSINESS_SCRAPER_TRACING)";
+        return false;
+    }
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        trace_state.last_error = "Could not create trace file: " + filename;
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    for (const auto& buffer : trace_state.buffers) {
+        // Name each thread so the timeline shows one labelled track per worker
+        file << (first ? "\n" : ",\n")
+             << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_index()
+             << ",\"args\":{\"name\":\"thread " << buffer->thread_index() << "\"}}";
+        first = false;
+
+        size_t count = buffer->size();
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->at(i);
+            file << ",\n{\"name\":";
+            write_json_string(file, event.name);
+            file << ",\"cat\":\"business_scraper\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_index()
+                 << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us << "}";
+        }
+    }
+
+    file << "\n]}\n";
+    file.close();
+
+    if (!file) {
+        trace_state.last_error = "Error writing trace file: " + filename;
+        return false;
+    }
+    return true;
+}
+
+std::string Tracer::last_error() {
+    std::lock_guard<std::mutex> lock(state().mutex);
+    return state().last_error;
+}
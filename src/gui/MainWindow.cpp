@@ -4,17 +4,43 @@
 #include "gui/ConfigDialog.h"
 #include "gui/StyleManager.h"
 #include "core/BusinessScraperEngine.h"
+#include "storage/RecordFile.h"
+#include "output/ParquetWriter.h"
 #include "utils/ConfigManager.h"
 
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QInputDialog>
 #include <QtWidgets/QSplitter>
 #include <QtCore/QThread>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QSettings>
 #include <QtCore/QTimer>
 
+namespace {
+    // Reads free text as the filter it most likely is: mostly digits is a phone
+    // number, a dotted word a website domain, anything else a name prefix
+    StoreQuery storeQueryFor(const QString& text)
+    {
+        StoreQuery query;
+        QString trimmed = text.trimmed();
+        int digits = 0;
+        for (QChar c : trimmed) {
+            if (c.isDigit()) digits++;
+        }
+
+        if (digits >= 7 && digits * 2 > trimmed.size()) {
+            query.phone = trimmed.toStdString();
+        } else if (trimmed.contains('.') && !trimmed.contains(' ')) {
+            query.domain = trimmed.toStdString();
+        } else {
+            query.name = trimmed.toStdString();
+        }
+        return query;
+    }
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_searchWidget(nullptr)
@@ -25,6 +51,8 @@ MainWindow::MainWindow(QWidget *parent)
     , m_resultCountLabel(nullptr)
     , m_engine(nullptr)
     , m_lastResults(nullptr)
+    , m_storePath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+                  QString("/results.%1").arg(QString::fromLatin1(ResultStoreFile::EXTENSION)))
     , m_searchInProgress(false)
     , m_statusTimer(new QTimer(this))
 {
@@ -104,6 +132,16 @@ void MainWindow::setupMenuBar()
     // File menu
     QMenu* fileMenu = menuBar()->addMenu("&File");
 
+    QAction* openAction = fileMenu->addAction("&Open Results...");
+    openAction->setShortcut(QKeySequence::Open);
+    openAction->setStatusTip("Load results saved as a binary record, JSON, JSON Lines or result store file");
+    connect(openAction, &QAction::triggered, this, &MainWindow::openResults);
+
+    QAction* searchStoreAction = fileMenu->addAction("&Search Saved Results...");
+    searchStoreAction->setShortcut(QKeySequence::Find);
+    searchStoreAction->setStatusTip("Find businesses from previous searches by name, phone or website");
+    connect(searchStoreAction, &QAction::triggered, this, &MainWindow::searchStore);
+
     QAction* exportAction = fileMenu->addAction("&Export Results...");
     exportAction->setShortcut(QKeySequence::SaveAs);
     exportAction->setStatusTip("Export search results to file");
@@ -200,12 +238,21 @@ void MainWindow::onSearchRequested()
     SearchOptions options = m_searchWidget->getSearchOptions();
 
     // Start search in background thread
-    QThread* searchThread = QThread::create([this, options]() {
-        SearchResults results = m_engine->search_businesses(options);
+    std::string storePath = m_storePath.toStdString();
+    QThread* searchThread = QThread::create([this, options, storePath]() {
+        SearchResults* results = new SearchResults(m_engine->search_businesses(options));
+
+        // Keep the results across sessions
+        std::string storeError;
+        if (results->success && !results->businesses.empty() &&
+            !m_engine->save_to_store(*results, storePath, storeError)) {
+            QMetaObject::invokeMethod(this, "onStatusUpdate", Qt::QueuedConnection,
+                Q_ARG(QString, QString("Could not save to result store: %1").arg(QString::fromStdString(storeError))));
+        }
 
-        // Store results and signal completion
+        // Hand the results over without copying and signal completion
         QMetaObject::invokeMethod(this, [this, results]() {
-            m_lastResults = new SearchResults(results);
+            m_lastResults = results;
             onSearchCompleted();
         }, Qt::QueuedConnection);
     });
@@ -337,28 +384,125 @@ void MainWindow::exportResults()
             defaultExt = "xml";
             filter = "XML Files (*.xml)";
             break;
+        case OutputFormat::JSONL:
+            defaultExt = "jsonl";
+            filter = "JSON Lines Files (*.jsonl)";
+            break;
     }
 
+    Compression compression = m_searchWidget->getCompression();
+    QString compressionSuffix;
+    if (compression != Compression::None) {
+        compressionSuffix = QString(".%1").arg(QString::fromLatin1(compression_extension(compression)));
+        defaultExt += compressionSuffix;
+        filter.chop(1);
+        filter += compressionSuffix + ")";
+    }
+    filter += QString(";;Binary Records (*.%1)").arg(QString::fromLatin1(RecordFile::EXTENSION));
+    filter += QString(";;Parquet Files (*.%1)").arg(QString::fromLatin1(ParquetFile::EXTENSION));
+
     QString filename = QFileDialog::getSaveFileName(this,
         "Export Results", QString("business_results.%1").arg(defaultExt), filter);
 
-    if (!filename.isEmpty()) {
-        QString content = QString::fromStdString(m_engine->format_results(*m_lastResults, format));
-
-        QFile file(filename);
-        if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            QTextStream out(&file);
-            out << content;
+    if (!filename.isEmpty() && filename.endsWith(QString(".%1").arg(QString::fromLatin1(RecordFile::EXTENSION)), Qt::CaseInsensitive)) {
+        std::string error;
+        if (m_engine->save_records(*m_lastResults, filename.toStdString(), error)) {
+            m_statusLabel->setText(QString("Results exported to %1").arg(QFileInfo(filename).fileName()));
+            m_statusTimer->start(5000);
+        } else {
+            QMessageBox::critical(this, "Export Error",
+                QString("Could not write to file: %1").arg(QString::fromStdString(error)));
+        }
+    } else if (!filename.isEmpty() && filename.endsWith(QString(".%1").arg(QString::fromLatin1(ParquetFile::EXTENSION)), Qt::CaseInsensitive)) {
+        // Parquet compresses each page itself, with gzip unless another codec is chosen
+        std::string error;
+        Compression codec = compression != Compression::None ? compression : Compression::Gzip;
+        if (m_engine->save_parquet(*m_lastResults, filename.toStdString(), error, codec)) {
+            m_statusLabel->setText(QString("Results exported to %1").arg(QFileInfo(filename).fileName()));
+            m_statusTimer->start(5000);
+        } else {
+            QMessageBox::critical(this, "Export Error",
+                QString("Could not write to file: %1").arg(QString::fromStdString(error)));
+        }
+    } else if (!filename.isEmpty()) {
+        if (!compressionSuffix.isEmpty() && !filename.endsWith(compressionSuffix, Qt::CaseInsensitive)) {
+            filename += compressionSuffix;
+        }
 
+        // Formatted (and compressed) straight into the file; the output is never held in memory.
+        // Only the fields chosen in the search panel are written.
+        m_engine->set_output_fields(m_searchWidget->getOutputFields());
+        std::string error;
+        if (m_engine->save_results(*m_lastResults, format, filename.toStdString(), error, compression)) {
             m_statusLabel->setText(QString("Results exported to %1").arg(QFileInfo(filename).fileName()));
             m_statusTimer->start(5000);
         } else {
             QMessageBox::critical(this, "Export Error",
-                QString("Could not write to file: %1").arg(filename));
+                QString("Could not write to file: %1").arg(QString::fromStdString(error)));
         }
     }
 }
 
+void MainWindow::openResults()
+{
+    if (m_searchInProgress) {
+        return;
+    }
+
+    QString recordExtension = QString::fromLatin1(RecordFile::EXTENSION);
+    QString storeExtension = QString::fromLatin1(ResultStoreFile::EXTENSION);
+    QString filter = QString("Results (*.%1 *.%2 *.json *.jsonl);;Binary Records (*.%1);;Result Stores (*.%2);;"
+                             "JSON Files (*.json *.jsonl)")
+        .arg(recordExtension, storeExtension);
+    QString filename = QFileDialog::getOpenFileName(this, "Open Results", QString(), filter);
+
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    showLoadedResults(new SearchResults(m_engine->load_results(filename.toStdString())));
+}
+
+void MainWindow::searchStore()
+{
+    if (m_searchInProgress) {
+        return;
+    }
+
+    bool accepted = false;
+    QString text = QInputDialog::getText(this, "Search Saved Results",
+        "Name, phone number or website (empty lists everything):", QLineEdit::Normal, QString(), &accepted);
+    if (!accepted) {
+        return;
+    }
+
+    SearchResults* results = new SearchResults(
+        m_engine->query_store(m_storePath.toStdString(), storeQueryFor(text)));
+    if (results->success && results->businesses.empty()) {
+        QMessageBox::information(this, "No Results",
+            QString("No saved businesses match '%1'.").arg(text.trimmed()));
+        delete results;
+        return;
+    }
+
+    showLoadedResults(results);
+}
+
+void MainWindow::showLoadedResults(SearchResults* results)
+{
+    if (!results->success) {
+        QMessageBox::critical(this, "Open Error",
+            QString("Could not load results: %1").arg(QString::fromStdString(results->error_message)));
+        delete results;
+        return;
+    }
+
+    m_resultsWidget->clearResults();
+    delete m_lastResults;
+    m_lastResults = results;
+    onSearchCompleted();
+}
+
 void MainWindow::openConfiguration()
 {
     ConfigDialog dialog(this);
@@ -1,11 +1,95 @@
 #include "gui/ResultsWidget.h"
 #include "gui/TableItemDelegate.h"
+#include "core/BusinessFields.h"
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QMenu>
 #include <QtCore/QUrl>
 #include <QtGui/QDesktopServices>
 
+namespace {
+    // Fields shown as table columns, in column order (see ResultsWidget::Columns)
+    using TableFields = BusinessFields::FieldList<
+        BusinessFields::FieldId::Name, BusinessFields::FieldId::Address, BusinessFields::FieldId::PhoneNumber,
+        BusinessFields::FieldId::Email, BusinessFields::FieldId::Website, BusinessFields::FieldId::Rating>;
+
+    QString fieldLabel(std::string_view label)
+    {
+        return QString::fromUtf8(label.data(), static_cast<int>(label.size()));
+    }
+
+    // The GUI keeps its own wording where it predates the shared export labels
+    template <typename Field>
+    QString displayLabel(Field)
+    {
+        if constexpr (Field::id == BusinessFields::FieldId::PhoneNumber) {
+            return "Phone";
+        } else {
+            return fieldLabel(Field::label);
+        }
+    }
+
+    template <typename Field>
+    QString columnHeader(Field field)
+    {
+        if constexpr (Field::id == BusinessFields::FieldId::Name) {
+            return "Business Name";
+        } else {
+            return displayLabel(field);
+        }
+    }
+
+    template <typename Field>
+    QTableWidgetItem* createTableItem(Field, const Business& business)
+    {
+        const auto& value = Field::get(business);
+
+        if constexpr (Field::type == BusinessFields::FieldType::Double) {
+            QTableWidgetItem* item = new QTableWidgetItem(value > 0 ? QString::number(value, 'f', 1) : "");
+            if (value > 0) {
+                item->setData(Qt::UserRole, value); // For proper sorting
+            }
+            return item;
+        } else if constexpr (Field::type == BusinessFields::FieldType::Int) {
+            QTableWidgetItem* item = new QTableWidgetItem(value > 0 ? QString::number(value) : "");
+            if (value > 0) {
+                item->setData(Qt::UserRole, value);
+            }
+            return item;
+        } else if constexpr (Field::type == BusinessFields::FieldType::StringList) {
+            QStringList values;
+            for (const auto& entry : value) {
+                values << QString::fromStdString(entry);
+            }
+            QTableWidgetItem* item = new QTableWidgetItem(values.join(", "));
+            item->setToolTip(values.join("\n"));
+            return item;
+        } else {
+            QString text = QString::fromStdString(value);
+
+            // Show the first alternative when the primary phone or email is missing
+            if constexpr (Field::id == BusinessFields::FieldId::PhoneNumber) {
+                if (text.isEmpty() && !business.additional_numbers().empty()) {
+                    text = QString::fromStdString(business.additional_numbers()[0]);
+                }
+            } else if constexpr (Field::id == BusinessFields::FieldId::Email) {
+                if (text.isEmpty() && !business.additional_emails().empty()) {
+                    text = QString::fromStdString(business.additional_emails()[0]);
+                }
+            }
+
+            QTableWidgetItem* item = new QTableWidgetItem(text);
+            item->setToolTip(text);
+            if constexpr (Field::id == BusinessFields::FieldId::Website) {
+                if (!text.isEmpty()) {
+                    item->setForeground(QColor(0, 123, 204)); // Blue color for links
+                }
+            }
+            return item;
+        }
+    }
+}
+
 ResultsWidget::ResultsWidget(QWidget *parent)
     : QWidget(parent)
     , m_resultsTable(nullptr)
@@ -63,8 +147,11 @@ void ResultsWidget::setupTable()
     // Set up columns
     m_resultsTable->setColumnCount(COL_COUNT);
 
+    static_assert(TableFields::size == COL_COUNT, "one table field per column");
     QStringList headers;
-    headers << "Business Name" << "Address" << "Phone" << "Email" << "Website" << "Rating";
+    BusinessFields::for_each_field([&headers](auto field) {
+        headers << columnHeader(field);
+    }, TableFields());
     m_resultsTable->setHorizontalHeaderLabels(headers);
 
     // Configure table appearance
@@ -155,51 +242,11 @@ void ResultsWidget::populateTable(const std::vector<Business>& businesses)
     for (size_t i = 0; i < businesses.size(); ++i) {
         const Business& business = businesses[i];
         int row = static_cast<int>(i);
+        int column = 0;
 
-        // Name
-        QTableWidgetItem* nameItem = new QTableWidgetItem(QString::fromStdString(business.name()));
-        nameItem->setToolTip(QString::fromStdString(business.name()));
-        m_resultsTable->setItem(row, COL_NAME, nameItem);
-
-        // Address
-        QTableWidgetItem* addressItem = new QTableWidgetItem(QString::fromStdString(business.address()));
-        addressItem->setToolTip(QString::fromStdString(business.address()));
-        m_resultsTable->setItem(row, COL_ADDRESS, addressItem);
-
-        // Phone
-        QString phone = QString::fromStdString(business.phone_number());
-        if (phone.isEmpty() && !business.additional_numbers().empty()) {
-            phone = QString::fromStdString(business.additional_numbers()[0]);
-        }
-        QTableWidgetItem* phoneItem = new QTableWidgetItem(phone);
-        phoneItem->setToolTip(phone);
-        m_resultsTable->setItem(row, COL_PHONE, phoneItem);
-
-        // Email
-        QString email = QString::fromStdString(business.email());
-        if (email.isEmpty() && !business.additional_emails().empty()) {
-            email = QString::fromStdString(business.additional_emails()[0]);
-        }
-        QTableWidgetItem* emailItem = new QTableWidgetItem(email);
-        emailItem->setToolTip(email);
-        m_resultsTable->setItem(row, COL_EMAIL, emailItem);
-
-        // Website
-        QString website = QString::fromStdString(business.website());
-        QTableWidgetItem* websiteItem = new QTableWidgetItem(website);
-        websiteItem->setToolTip(website);
-        if (!website.isEmpty()) {
-            websiteItem->setForeground(QColor(0, 123, 204)); // Blue color for links
-        }
-        m_resultsTable->setItem(row, COL_WEBSITE, websiteItem);
-
-        // Rating
-        QString rating = business.rating() > 0 ? QString::number(business.rating(), 'f', 1) : "";
-        QTableWidgetItem* ratingItem = new QTableWidgetItem(rating);
-        if (business.rating() > 0) {
-            ratingItem->setData(Qt::UserRole, business.rating()); // For proper sorting
-        }
-        m_resultsTable->setItem(row, COL_RATING, ratingItem);
+        BusinessFields::for_each_field([&](auto field) {
+            m_resultsTable->setItem(row, column++, createTableItem(field, business));
+        }, TableFields());
     }
 
     m_resultsTable->setSortingEnabled(true);
@@ -316,23 +363,32 @@ void ResultsWidget::showContextMenu(const QPoint& pos)
 QString ResultsWidget::formatBusinessForClipboard(const Business& business) const
 {
     QString text;
-    text += QString("Name: %1\n").arg(QString::fromStdString(business.name()));
-    text += QString("Address: %1\n").arg(QString::fromStdString(business.address()));
 
-    if (!business.phone_number().empty()) {
-        text += QString("Phone: %1\n").arg(QString::fromStdString(business.phone_number()));
-    }
-
-    if (!business.email().empty()) {
-        text += QString("Email: %1\n").arg(QString::fromStdString(business.email()));
-    }
+    // Every exported field that has a value, one "Label: value" line each
+    BusinessFields::for_each_value(business, [&text](auto field, const auto& value) {
+        using Field = decltype(field);
+        QString shown;
+        if constexpr (Field::type == BusinessFields::FieldType::String) {
+            shown = QString::fromStdString(value);
+        } else if constexpr (Field::type == BusinessFields::FieldType::Double) {
+            if (value > 0) shown = QString::number(value, 'f', 1);
+        } else if constexpr (Field::type == BusinessFields::FieldType::Int) {
+            if (value > 0) shown = QString::number(value);
+        } else {
+            QStringList values;
+            for (const auto& entry : value) {
+                values << QString::fromStdString(entry);
+            }
+            shown = values.join(", ");
+        }
 
-    if (!business.website().empty()) {
-        text += QString("Website: %1\n").arg(QString::fromStdString(business.website()));
-    }
+        if (!shown.isEmpty()) {
+            text += QString("%1: %2\n").arg(displayLabel(field), shown);
+        }
+    });
 
-    if (business.rating() > 0) {
-        text += QString("Rating: %1\n").arg(business.rating(), 0, 'f', 1);
+    if (business.has_coordinates()) {
+        text += QString("Location: %1, %2\n").arg(business.latitude(), 0, 'f', 6).arg(business.longitude(), 0, 'f', 6);
     }
 
     return text;
@@ -9,7 +9,13 @@ SearchWidget::SearchWidget(QWidget *parent)
     , m_locationEdit(nullptr)
     , m_resultsSpinBox(nullptr)
     , m_webScrapingCheckBox(nullptr)
+    , m_mergeDuplicatesCheckBox(nullptr)
+    , m_mergeSimilarNamesCheckBox(nullptr)
+    , m_mergeNearbySpinBox(nullptr)
     , m_formatComboBox(nullptr)
+    , m_compressionComboBox(nullptr)
+    , m_fieldsButton(nullptr)
+    , m_fieldsMenu(nullptr)
     , m_searchButton(nullptr)
     , m_clearButton(nullptr)
     , m_searchGroup(nullptr)
@@ -60,12 +66,56 @@ void SearchWidget::setupUI()
     m_webScrapingCheckBox->setToolTip("Scrape business websites for additional contact information");
     optionsLayout->addRow(m_webScrapingCheckBox);
 
+    // Duplicate merging option
+    m_mergeDuplicatesCheckBox = new QCheckBox("Merge duplicate listings", this);
+    m_mergeDuplicatesCheckBox->setChecked(false);
+    m_mergeDuplicatesCheckBox->setToolTip("Merge results that share a phone number, website or address");
+    optionsLayout->addRow(m_mergeDuplicatesCheckBox);
+
+    m_mergeSimilarNamesCheckBox = new QCheckBox("Merge similar names", this);
+    m_mergeSimilarNamesCheckBox->setChecked(false);
+    m_mergeSimilarNamesCheckBox->setToolTip("Merge results at the same address or phone whose names differ only slightly");
+    optionsLayout->addRow(m_mergeSimilarNamesCheckBox);
+
+    m_mergeNearbySpinBox = new QSpinBox(this);
+    m_mergeNearbySpinBox->setRange(0, 1000);
+    m_mergeNearbySpinBox->setSingleStep(10);
+    m_mergeNearbySpinBox->setSuffix(" m");
+    m_mergeNearbySpinBox->setSpecialValueText("Off");
+    m_mergeNearbySpinBox->setToolTip("Merge results with similar names within this distance of each other");
+    optionsLayout->addRow("Merge &Nearby:", m_mergeNearbySpinBox);
+
     // Output format
     m_formatComboBox = new QComboBox(this);
-    m_formatComboBox->addItems({"CSV", "JSON", "YAML", "XML"});
+    m_formatComboBox->addItems({"CSV", "JSON", "YAML", "XML", "JSON Lines"});
     m_formatComboBox->setToolTip("Output format for exported results");
     optionsLayout->addRow("Export &Format:", m_formatComboBox);
 
+    m_compressionComboBox = new QComboBox(this);
+    m_compressionComboBox->addItem("None", static_cast<int>(Compression::None));
+    m_compressionComboBox->addItem("gzip (.gz)", static_cast<int>(Compression::Gzip));
+    if (compression_supported(Compression::Zstd)) {
+        m_compressionComboBox->addItem("zstd (.zst)", static_cast<int>(Compression::Zstd));
+    }
+    m_compressionComboBox->setToolTip("Compress exported files as they are written");
+    optionsLayout->addRow("Export &Compression:", m_compressionComboBox);
+
+    // Column chooser: one checkable entry per exported field
+    m_fieldsMenu = new QMenu(this);
+    for (size_t i = 0; i < BusinessFields::FIELD_COUNT; ++i) {
+        std::string_view label = BusinessFields::FIELDS[i].label;
+        QAction* action = m_fieldsMenu->addAction(QString::fromUtf8(label.data(), static_cast<int>(label.size())));
+        action->setCheckable(true);
+        action->setChecked(true);
+        action->setData(static_cast<int>(i));
+    }
+    m_fieldsButton = new QToolButton(this);
+    m_fieldsButton->setMenu(m_fieldsMenu);
+    m_fieldsButton->setPopupMode(QToolButton::InstantPopup);
+    m_fieldsButton->setToolTip("Fields written to exported files; unselected fields are left out");
+    optionsLayout->addRow("Export F&ields:", m_fieldsButton);
+    updateFieldsButton();
+
     mainLayout->addWidget(m_optionsGroup);
 
     // Buttons
@@ -122,10 +172,28 @@ void SearchWidget::setupConnections()
         m_locationEdit->clear();
         m_resultsSpinBox->setValue(20);
         m_webScrapingCheckBox->setChecked(true);
+        m_mergeDuplicatesCheckBox->setChecked(false);
+        m_mergeSimilarNamesCheckBox->setChecked(false);
+        m_mergeNearbySpinBox->setValue(0);
         m_formatComboBox->setCurrentIndex(0);
+        m_compressionComboBox->setCurrentIndex(0);
+        for (QAction* action : m_fieldsMenu->actions()) {
+            action->setChecked(true);
+        }
         validateInput();
     });
 
+    // At least one field stays selected
+    for (QAction* action : m_fieldsMenu->actions()) {
+        connect(action, &QAction::toggled, [this, action](bool checked) {
+            if (!checked && selectedFieldCount() == 0) {
+                action->setChecked(true);
+                return;
+            }
+            updateFieldsButton();
+        });
+    }
+
     // Enter key in line edits triggers search
     connect(m_keywordEdit, &QLineEdit::returnPressed, this, &SearchWidget::onSearchClicked);
     connect(m_locationEdit, &QLineEdit::returnPressed, this, &SearchWidget::onSearchClicked);
@@ -172,6 +240,9 @@ SearchOptions SearchWidget::getSearchOptions() const
     options.max_radius = 5000; // Default radius since UI control is removed
     options.max_results = m_resultsSpinBox->value();
     options.enhance_with_web_scraping = m_webScrapingCheckBox->isChecked();
+    options.merge_duplicates = m_mergeDuplicatesCheckBox->isChecked();
+    options.merge_similar_names = m_mergeSimilarNamesCheckBox->isChecked();
+    options.merge_nearby_meters = m_mergeNearbySpinBox->value();
     return options;
 }
 
@@ -182,10 +253,46 @@ OutputFormat SearchWidget::getOutputFormat() const
         case 1: return OutputFormat::JSON;
         case 2: return OutputFormat::YAML;
         case 3: return OutputFormat::XML;
+        case 4: return OutputFormat::JSONL;
         default: return OutputFormat::CSV;
     }
 }
 
+Compression SearchWidget::getCompression() const
+{
+    return static_cast<Compression>(m_compressionComboBox->currentData().toInt());
+}
+
+std::vector<BusinessFields::FieldId> SearchWidget::getOutputFields() const
+{
+    std::vector<BusinessFields::FieldId> fields;
+    for (QAction* action : m_fieldsMenu->actions()) {
+        if (action->isChecked()) {
+            fields.push_back(static_cast<BusinessFields::FieldId>(action->data().toInt()));
+        }
+    }
+    if (fields.size() == BusinessFields::FIELD_COUNT) {
+        fields.clear();
+    }
+    return fields;
+}
+
+size_t SearchWidget::selectedFieldCount() const
+{
+    size_t selected = 0;
+    for (QAction* action : m_fieldsMenu->actions()) {
+        selected += action->isChecked() ? 1 : 0;
+    }
+    return selected;
+}
+
+void SearchWidget::updateFieldsButton()
+{
+    size_t selected = selectedFieldCount();
+    m_fieldsButton->setText(selected == BusinessFields::FIELD_COUNT ? QString("All fields")
+                            : QString("%1 of %2 fields").arg(selected).arg(BusinessFields::FIELD_COUNT));
+}
+
 void SearchWidget::setSearchEnabled(bool enabled)
 {
     m_searchButton->setEnabled(enabled && isValid());
@@ -193,7 +300,12 @@ void SearchWidget::setSearchEnabled(bool enabled)
     m_locationEdit->setEnabled(enabled);
     m_resultsSpinBox->setEnabled(enabled);
     m_webScrapingCheckBox->setEnabled(enabled);
+    m_mergeDuplicatesCheckBox->setEnabled(enabled);
+    m_mergeSimilarNamesCheckBox->setEnabled(enabled);
+    m_mergeNearbySpinBox->setEnabled(enabled);
     m_formatComboBox->setEnabled(enabled);
+    m_compressionComboBox->setEnabled(enabled);
+    m_fieldsButton->setEnabled(enabled);
     m_clearButton->setEnabled(enabled);
 }
 
@@ -212,7 +324,29 @@ void SearchWidget::loadSettings()
     m_locationEdit->setText(settings.value("location", "").toString());
     m_resultsSpinBox->setValue(settings.value("maxResults", 20).toInt());
     m_webScrapingCheckBox->setChecked(settings.value("webScraping", true).toBool());
+    m_mergeDuplicatesCheckBox->setChecked(settings.value("mergeDuplicates", false).toBool());
+    m_mergeSimilarNamesCheckBox->setChecked(settings.value("mergeSimilarNames", false).toBool());
+    m_mergeNearbySpinBox->setValue(settings.value("mergeNearbyMeters", 0).toInt());
     m_formatComboBox->setCurrentIndex(settings.value("format", 0).toInt());
+    // Stored by codec rather than index, as zstd is only listed when supported
+    int compression = m_compressionComboBox->findData(settings.value("compression", 0).toInt());
+    m_compressionComboBox->setCurrentIndex(compression >= 0 ? compression : 0);
+    // Stored by key; no entry (or no known key) selects every field
+    QStringList fieldKeys = settings.value("fields").toStringList();
+    std::vector<bool> stored(BusinessFields::FIELD_COUNT, false);
+    bool anyStored = false;
+    for (size_t i = 0; i < BusinessFields::FIELD_COUNT; ++i) {
+        std::string_view key = BusinessFields::FIELDS[i].key;
+        stored[i] = fieldKeys.contains(QString::fromUtf8(key.data(), static_cast<int>(key.size())));
+        anyStored = anyStored || stored[i];
+    }
+    // Check before unchecking, so the one-field minimum never interferes
+    for (QAction* action : m_fieldsMenu->actions()) {
+        action->setChecked(true);
+    }
+    for (QAction* action : m_fieldsMenu->actions()) {
+        action->setChecked(!anyStored || stored[action->data().toInt()]);
+    }
 
     settings.endGroup();
 }
@@ -226,7 +360,17 @@ void SearchWidget::saveSettings()
     settings.setValue("location", m_locationEdit->text());
     settings.setValue("maxResults", m_resultsSpinBox->value());
     settings.setValue("webScraping", m_webScrapingCheckBox->isChecked());
+    settings.setValue("mergeDuplicates", m_mergeDuplicatesCheckBox->isChecked());
+    settings.setValue("mergeSimilarNames", m_mergeSimilarNamesCheckBox->isChecked());
+    settings.setValue("mergeNearbyMeters", m_mergeNearbySpinBox->value());
     settings.setValue("format", m_formatComboBox->currentIndex());
+    settings.setValue("compression", m_compressionComboBox->currentData().toInt());
+    QStringList fieldKeys;
+    for (BusinessFields::FieldId id : getOutputFields()) {
+        std::string_view key = BusinessFields::info(id).key;
+        fieldKeys << QString::fromUtf8(key.data(), static_cast<int>(key.size()));
+    }
+    settings.setValue("fields", fieldKeys);
 
     settings.endGroup();
 }
@@ -3,22 +3,55 @@
 #include <getopt.h>
 #include <cstdlib>
 #include <algorithm>
+#include <filesystem>
 
 #include "core/BusinessScraperEngine.h"
+#include "core/Trace.h"
 #include "utils/ConfigManager.h"
 #include "utils/FileUtils.h"
+#include "storage/RecordFile.h"
+#include "output/ParquetWriter.h"
+#include "output/IncrementalWriter.h"
 
 // Structure to hold program options
 struct ProgramOptions {
     SearchOptions search_options;
     OutputFormat output_format = OutputFormat::CSV;
     std::string output_filename;  // Custom output filename
+    std::string batch_filename;   // CSV file of keyword/location jobs
+    std::string checkpoint_filename;
+    size_t memory_budget_bytes = 0;
+    std::string metrics_filename;  // JSON, or Prometheus text for .prom files
+    std::string trace_filename;    // Chrome trace-event JSON
+    std::string load_filename;     // Binary record, JSON or JSON Lines file to load instead of searching
+    std::string diff_filename;     // Previous output to report changes against
+    std::string refresh_filename;  // Previous output to bring up to date
+    int refresh_ttl_hours = 24;    // Records fetched more recently are reused by --refresh
+    std::string store_filename;    // SQLite result store to add results to, or to query
+    StoreQuery store_query;
+    bool query_store = false;      // Read results from the store instead of searching
+    bool binary_output = false;    // Save a binary record file instead of formatted text
+    bool parquet_output = false;   // Save a columnar Parquet file instead of formatted text
+    Compression compression = Compression::None;
+    bool compression_given = false;  // Parquet pages default to gzip rather than None
+    bool incremental = false;      // Write each business to the output file as it is found
+    std::vector<BusinessFields::FieldId> fields;  // Output columns; empty writes all of them
+    int max_concurrency = 4;
     bool show_help = false;
 };
 
 // Function declarations
 void print_usage(const char* program_name);
 bool parse_command_line(int argc, char** argv, ProgramOptions& options);
+bool load_batch_jobs(const std::string& filename, const SearchOptions& defaults, std::vector<SearchOptions>& jobs);
+bool parse_store_filter(const std::string& filter, StoreQuery& query);
+bool parse_field_list(const std::string& list, std::vector<BusinessFields::FieldId>& fields);
+bool save_results(const BusinessScraperEngine& engine, const SearchResults& results, const ProgramOptions& options,
+                  const std::string& filename, std::string& error_message);
+bool write_diff(const BusinessScraperEngine& engine, const SearchResults& results, const ProgramOptions& options,
+                const std::string& output_filename);
+void write_metrics(const BusinessScraperEngine& engine, const std::string& filename);
+void write_trace(const std::string& filename);
 
 int main(int argc, char** argv) {
     ProgramOptions options;
@@ -33,95 +66,285 @@ int main(int argc, char** argv) {
         return 0;
     }
 
-    // Load configuration
-    ConfigManager config_manager;
-    if (!config_manager.load_config()) {
-        std::cerr << "Error: Could not load config.ini file. Please create it from config.template.ini" << std::endl;
-        std::cerr << "Config error: " << config_manager.last_error() << std::endl;
-        return 1;
-    }
+    // Create the scraper engine
+    BusinessScraperEngine engine;
 
-    std::string api_key = config_manager.get_api_key();
-    if (api_key.empty()) {
-        std::cerr << "Error: google_maps_api_key not found in config.ini" << std::endl;
-        return 1;
-    }
+    // Loading saved records needs no API access
+    if (options.load_filename.empty() && !options.query_store) {
+        // Load configuration
+        ConfigManager config_manager;
+        if (!config_manager.load_config()) {
+            std::cerr << "Error: Could not load config.ini file. Please create it from config.template.ini" << std::endl;
+            std::cerr << "Config error: " << config_manager.last_error() << std::endl;
+            return 1;
+        }
 
-    // Create and configure the scraper engine
-    BusinessScraperEngine engine;
-    if (!engine.set_api_key(api_key)) {
-        std::cerr << "Error: Invalid API key" << std::endl;
-        return 1;
+        std::string api_key = config_manager.get_api_key();
+        if (api_key.empty()) {
+            std::cerr << "Error: google_maps_api_key not found in config.ini" << std::endl;
+            return 1;
+        }
+
+        if (!engine.set_api_key(api_key)) {
+            std::cerr << "Error: Invalid API key" << std::endl;
+            return 1;
+        }
     }
 
     // Set up console output callbacks
     engine.set_status_callback([](const std::string& message) {
         std::cout << message << std::endl;
     });
+    engine.set_output_fields(options.fields);
 
-    // Display search parameters
-    std::cout << "Searching for '" << options.search_options.keyword
-              << "' in '" << options.search_options.location << "'..." << std::endl;
-    std::cout << "Max radius: " << options.search_options.max_radius << " meters" << std::endl;
-    std::cout << "Max results: " << options.search_options.max_results << std::endl;
-    std::cout << "Web scraping: " << (options.search_options.enhance_with_web_scraping ? "enabled" : "disabled") << std::endl << std::endl;
+    if (!options.trace_filename.empty()) {
+        if (Tracer::is_compiled_in()) {
+            Tracer::start();
+        } else {
+            std::cerr << "Warning: --trace ignored, this build was compiled without tracing" << std::endl;
+            options.trace_filename.clear();
+        }
+    }
 
-    // Perform the search
-    SearchResults results = engine.search_businesses(options.search_options);
+    // Output filename, chosen up front so incremental output can start with the run
+    std::string filename;
+    if (!options.output_filename.empty()) {
+        // Use custom filename provided by user
+        filename = options.output_filename;
+    } else if (options.binary_output) {
+        filename = FileUtils::join_paths(FileUtils::get_output_directory(),
+                                         FileUtils::get_timestamp_string() + "." + RecordFile::EXTENSION);
+    } else if (options.parquet_output) {
+        filename = FileUtils::join_paths(FileUtils::get_output_directory(),
+                                         FileUtils::get_timestamp_string() + "." + ParquetFile::EXTENSION);
+    } else {
+        // Generate timestamped filename
+        filename = FileUtils::generate_output_filename(options.output_format);
+    }
+    if (options.compression != Compression::None && !options.parquet_output) {
+        std::string suffix = std::string(".") + compression_extension(options.compression);
+        if (filename.size() < suffix.size() || filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            filename += suffix;
+        }
+    }
+
+    // Incremental output appends each business to FILENAME.partial as the batch finds it
+    IncrementalWriter incremental_writer;
+    if (options.incremental) {
+        Formatter formatter(options.output_format);
+        formatter.set_fields(options.fields);
+        if (!incremental_writer.open(filename, formatter, options.compression)) {
+            std::cerr << "Error: " << incremental_writer.last_error() << std::endl;
+            return 1;
+        }
+    }
+
+    SearchResults results;
+
+    if (options.query_store) {
+        std::cout << "Querying store '" << options.store_filename << "'..." << std::endl;
+        results = engine.query_store(options.store_filename, options.store_query);
+    } else if (!options.load_filename.empty()) {
+        std::cout << "Loading records from '" << options.load_filename << "'..." << std::endl;
+        results = engine.load_results(options.load_filename);
+        if (results.success && options.search_options.merge_duplicates) {
+            engine.merge_duplicates(results);
+        }
+        if (results.success && options.search_options.merge_similar_names) {
+            engine.merge_similar_names(results);
+        }
+        if (results.success && options.search_options.merge_nearby_meters > 0.0) {
+            engine.merge_nearby(results, options.search_options.merge_nearby_meters);
+        }
+    } else if (!options.refresh_filename.empty()) {
+        SearchResults previous = engine.load_results(options.refresh_filename);
+        if (previous.success) {
+            std::cout << "Refreshing " << previous.businesses.size() << " records from '" << options.refresh_filename
+                      << "' (TTL " << options.refresh_ttl_hours << " hours)..." << std::endl;
+            results = engine.refresh_results(options.search_options, previous,
+                                             static_cast<int64_t>(options.refresh_ttl_hours) * 3600);
+        } else {
+            results.error_message = previous.error_message;
+        }
+    } else if (!options.batch_filename.empty()) {
+        BatchOptions batch_options;
+        batch_options.max_concurrency = options.max_concurrency;
+        batch_options.checkpoint_filename = options.checkpoint_filename;
+        batch_options.memory_budget_bytes = options.memory_budget_bytes;
+        batch_options.merge_duplicates = options.search_options.merge_duplicates;
+        batch_options.merge_similar_names = options.search_options.merge_similar_names;
+        batch_options.merge_nearby_meters = options.search_options.merge_nearby_meters;
+        if (options.incremental) {
+            batch_options.result_callback = [&](const Business& business) { incremental_writer.write(business); };
+        }
+        if (!load_batch_jobs(options.batch_filename, options.search_options, batch_options.jobs)) {
+            incremental_writer.discard();
+            return 1;
+        }
+
+        // Display batch parameters
+        std::cout << "Running " << batch_options.jobs.size() << " jobs from '" << options.batch_filename << "'..." << std::endl;
+        std::cout << "Concurrency: " << batch_options.max_concurrency << std::endl;
+        std::cout << "Web scraping: " << (options.search_options.enhance_with_web_scraping ? "enabled" : "disabled") << std::endl << std::endl;
+
+        // Perform the batch
+        results = engine.search_batch(batch_options);
+    } else {
+        // Display search parameters
+        std::cout << "Searching for '" << options.search_options.keyword
+                  << "' in '" << options.search_options.location << "'..." << std::endl;
+        std::cout << "Max radius: " << options.search_options.max_radius << " meters" << std::endl;
+        std::cout << "Max results: " << options.search_options.max_results << std::endl;
+        std::cout << "Web scraping: " << (options.search_options.enhance_with_web_scraping ? "enabled" : "disabled") << std::endl << std::endl;
+
+        // Perform the search (as a one-job batch when it is checkpointed, memory-bounded or incremental)
+        if (!options.checkpoint_filename.empty() || options.memory_budget_bytes > 0 || options.incremental) {
+            BatchOptions batch_options;
+            batch_options.jobs.push_back(options.search_options);
+            batch_options.checkpoint_filename = options.checkpoint_filename;
+            batch_options.memory_budget_bytes = options.memory_budget_bytes;
+            batch_options.merge_duplicates = options.search_options.merge_duplicates;
+            batch_options.merge_similar_names = options.search_options.merge_similar_names;
+            batch_options.merge_nearby_meters = options.search_options.merge_nearby_meters;
+            if (options.incremental) {
+                batch_options.result_callback = [&](const Business& business) { incremental_writer.write(business); };
+            }
+            results = engine.search_batch(batch_options);
+        } else {
+            results = engine.search_businesses(options.search_options);
+        }
+    }
 
     if (!results.success) {
-        std::cerr << "Search failed: " << results.error_message << std::endl;
+        const char* prefix = options.query_store ? "Query failed: " :
+                             !options.load_filename.empty() ? "Load failed: " :
+                             !options.refresh_filename.empty() ? "Refresh failed: " : "Search failed: ";
+        std::cerr << prefix << results.error_message << std::endl;
+        if (options.incremental && incremental_writer.record_count() > 0) {
+            std::cerr << "Partial output kept in: " << incremental_writer.partial_filename() << std::endl;
+        } else {
+            incremental_writer.discard();
+        }
+        write_metrics(engine, options.metrics_filename);
+        write_trace(options.trace_filename);
         return 1;
     }
 
-    if (results.businesses.empty()) {
+    if (results.total_found == 0) {
         std::cout << "No businesses found." << std::endl;
+        incremental_writer.discard();
+        write_metrics(engine, options.metrics_filename);
+        write_trace(options.trace_filename);
         return 0;
     }
 
-    // Format and save results
-    std::string formatted_output = engine.format_results(results, options.output_format);
-    if (formatted_output.empty()) {
-        std::cerr << "Error: Failed to format results" << std::endl;
-        return 1;
-    }
-
-    // Generate output filename and save
-    std::string filename;
-    if (!options.output_filename.empty()) {
-        // Use custom filename provided by user
-        filename = options.output_filename;
+    std::string save_error;
+    bool saved;
+    if (options.incremental) {
+        // Every record is already written; close the framing and move the file into place
+        saved = incremental_writer.finish();
+        save_error = incremental_writer.last_error();
     } else {
-        // Generate timestamped filename
-        filename = FileUtils::generate_output_filename(options.output_format);
+        saved = save_results(engine, results, options, filename, save_error);
     }
 
-    if (FileUtils::write_to_file(formatted_output, filename)) {
+    if (saved) {
         std::cout << "\nFound " << results.total_found << " businesses." << std::endl;
+        if (results.resumed_count > 0) {
+            std::cout << "Resumed " << results.resumed_count << " businesses from checkpoint." << std::endl;
+        }
+        if (results.duplicates_skipped > 0) {
+            std::cout << "Skipped " << results.duplicates_skipped << " duplicates across jobs." << std::endl;
+        }
+        if (results.merged_count > 0) {
+            std::cout << "Merged " << results.merged_count << " duplicate records." << std::endl;
+        }
+        if (results.similar_names_merged > 0) {
+            std::cout << "Merged " << results.similar_names_merged << " records with similar names." << std::endl;
+        }
+        if (results.nearby_merged > 0) {
+            std::cout << "Merged " << results.nearby_merged << " nearby records with similar names." << std::endl;
+        }
+        if (!results.saturated_jobs.empty()) {
+            std::cout << "Saturated jobs (split into smaller tiles):";
+            for (int job : results.saturated_jobs) {
+                std::cout << " " << (job + 1);
+            }
+            std::cout << std::endl;
+        }
+        if (results.refreshed_count > 0 || results.reused_count > 0) {
+            std::cout << "Refreshed " << results.refreshed_count << " stale records, reused "
+                      << results.reused_count << " fresh ones." << std::endl;
+        }
         if (results.enhanced_count > 0) {
             std::cout << "Enhanced " << results.enhanced_count << " businesses with website data." << std::endl;
         }
         std::cout << "Results saved to: " << filename << std::endl;
     } else {
-        std::cout << "Error saving results to file: " << FileUtils::last_error() << std::endl;
-        std::cout << "Printing to console instead:" << std::endl;
-        std::cout << formatted_output << std::endl;
+        std::cout << "Error saving results to file: " << save_error << std::endl;
+        if (!options.binary_output && !options.parquet_output) {
+            std::cout << "Printing to console instead:" << std::endl;
+            engine.write_results(results, options.output_format, std::cout);
+            std::cout << std::endl;
+        }
     }
 
+    if (!options.store_filename.empty() && !options.query_store) {
+        if (engine.save_to_store(results, options.store_filename, save_error)) {
+            std::cout << "Stored " << results.total_found << " businesses in: " << options.store_filename << std::endl;
+        } else {
+            std::cerr << "Error updating store: " << save_error << std::endl;
+            write_metrics(engine, options.metrics_filename);
+            write_trace(options.trace_filename);
+            return 1;
+        }
+    }
+
+    if (!options.diff_filename.empty() && !write_diff(engine, results, options, filename)) {
+        write_metrics(engine, options.metrics_filename);
+        write_trace(options.trace_filename);
+        return 1;
+    }
+
+    write_metrics(engine, options.metrics_filename);
+    write_trace(options.trace_filename);
+
     return 0;
 }
 
 // Function definitions
 void print_usage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [OPTIONS]\n\n"
-              << "Required options:\n"
+              << "Required options (unless --batch, --load or --query is given):\n"
               << "  -k, --keyword KEYWORD     Search keyword (e.g., 'restaurants', 'coffee shops')\n"
               << "  -l, --location LOCATION   Location to search (e.g., 'New York, NY')\n\n"
               << "Optional options:\n"
               << "  -d, --distance METERS     Max search radius in meters (default: 5000)\n"
               << "  -r, --results NUMBER      Max number of results (default: 20)\n"
-              << "  -f, --format FORMAT       Output format: csv, json, yaml, xml (default: csv)\n"
+              << "  -f, --format FORMAT       Output format: csv, json, jsonl, yaml, xml, binary, parquet (default: csv)\n"
               << "  -o, --output FILENAME     Output filename (default: auto-generated with timestamp)\n"
+              << "  -z, --compress CODEC      Compress the output as it is written: gzip or zstd (adds .gz/.zst);\n"
+              << "                            for parquet, the page codec (default: gzip)\n"
+              << "  -i, --incremental         Write businesses to FILENAME.partial as they are found, renaming it\n"
+              << "                            to FILENAME when the run completes (text formats, no merging)\n"
+              << "  -F, --fields LIST         Write only these comma-separated fields, in this order\n"
+              << "                            (e.g. name,phone_number,website; default: all)\n"
+              << "  -b, --batch FILENAME      Run every job in a CSV file (keyword,location[,distance,results])\n"
+              << "  -j, --concurrency NUMBER  Max concurrent batch jobs (default: 4)\n"
+              << "  -c, --checkpoint FILENAME Journal progress to FILENAME and resume from it after a crash\n"
+              << "  -M, --memory-budget MB    Spill results to disk beyond MB megabytes of memory\n"
+              << "  -m, --metrics FILENAME    Write run metrics as JSON (Prometheus text if FILENAME ends in .prom)\n"
+              << "  -t, --trace FILENAME      Write a Chrome trace-event timeline (tracing builds only)\n"
+              << "  -L, --load FILENAME       Load results from a binary record or JSON(L) file instead of searching\n"
+              << "  -R, --refresh FILENAME    Update a previous binary record file or result store, refetching only stale records\n"
+              << "  -T, --ttl HOURS           Records younger than HOURS are reused by --refresh (default: 24)\n"
+              << "  -D, --diff FILENAME       Save records added, removed or changed since a previous binary or JSON output\n"
+              << "  -S, --store FILENAME      Also add the results to a SQLite result store, updating known businesses\n"
+              << "  -Q, --query FILTER        Read results from the --store instead of searching; FILTER is\n"
+              << "                            name=PREFIX, phone=NUMBER or domain=DOMAIN (repeat to combine)\n"
+              << "  -u, --merge-duplicates    Merge records sharing a place ID or two of phone/website/address\n"
+              << "  -s, --merge-similar       Merge near-identical names at the same address or phone\n"
+              << "  -P, --merge-nearby METERS Merge similar names within METERS of each other\n"
               << "  --no-web-scraping        Disable web scraping enhancement (faster but less data)\n"
               << "  -h, --help               Show this help message\n\n"
               << "The Google Maps API key should be configured in config.ini file.\n"
@@ -138,6 +361,24 @@ bool parse_command_line(int argc, char** argv, ProgramOptions& options) {
         {"results",         required_argument, 0, 'r'},
         {"format",          required_argument, 0, 'f'},
         {"output",          required_argument, 0, 'o'},
+        {"compress",        required_argument, 0, 'z'},
+        {"fields",          required_argument, 0, 'F'},
+        {"incremental",     no_argument,       0, 'i'},
+        {"batch",           required_argument, 0, 'b'},
+        {"concurrency",     required_argument, 0, 'j'},
+        {"checkpoint",      required_argument, 0, 'c'},
+        {"metrics",         required_argument, 0, 'm'},
+        {"memory-budget",   required_argument, 0, 'M'},
+        {"trace",           required_argument, 0, 't'},
+        {"load",            required_argument, 0, 'L'},
+        {"diff",            required_argument, 0, 'D'},
+        {"refresh",         required_argument, 0, 'R'},
+        {"ttl",             required_argument, 0, 'T'},
+        {"store",           required_argument, 0, 'S'},
+        {"query",           required_argument, 0, 'Q'},
+        {"merge-duplicates", no_argument,      0, 'u'},
+        {"merge-similar",   no_argument,       0, 's'},
+        {"merge-nearby",    required_argument, 0, 'P'},
         {"no-web-scraping", no_argument,       0, 'n'},
         {"help",            no_argument,       0, 'h'},
         {0, 0, 0, 0}
@@ -147,7 +388,7 @@ bool parse_command_line(int argc, char** argv, ProgramOptions& options) {
     int c;
 
     // Parse command line arguments
-    while ((c = getopt_long(argc, argv, "k:l:d:r:f:o:nh", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "k:l:d:r:f:o:z:F:ib:j:c:m:M:t:L:D:R:T:S:Q:usP:nh", long_options, &option_index)) != -1) {
         switch (c) {
             case 'k':
                 options.search_options.keyword = optarg;
@@ -181,8 +422,14 @@ bool parse_command_line(int argc, char** argv, ProgramOptions& options) {
                     options.output_format = OutputFormat::YAML;
                 } else if (format_str == "xml") {
                     options.output_format = OutputFormat::XML;
+                } else if (format_str == "jsonl" || format_str == "ndjson") {
+                    options.output_format = OutputFormat::JSONL;
+                } else if (format_str == "binary" || format_str == RecordFile::EXTENSION) {
+                    options.binary_output = true;
+                } else if (format_str == ParquetFile::EXTENSION) {
+                    options.parquet_output = true;
                 } else {
-                    std::cerr << "Error: Invalid format '" << optarg << "'. Valid formats are: csv, json, yaml, xml" << std::endl;
+                    std::cerr << "Error: Invalid format '" << optarg << "'. Valid formats are: csv, json, jsonl, yaml, xml, binary, parquet" << std::endl;
                     return false;
                 }
                 break;
@@ -190,6 +437,107 @@ bool parse_command_line(int argc, char** argv, ProgramOptions& options) {
             case 'o':
                 options.output_filename = optarg;
                 break;
+            case 'z': {
+                std::string codec = optarg;
+                std::transform(codec.begin(), codec.end(), codec.begin(), ::tolower);
+
+                if (codec == "gzip" || codec == "gz") {
+                    options.compression = Compression::Gzip;
+                } else if (codec == "zstd" || codec == "zst") {
+                    options.compression = Compression::Zstd;
+                } else if (codec == "none") {
+                    options.compression = Compression::None;
+                } else {
+                    std::cerr << "Error: Invalid compression '" << optarg << "'. Valid codecs are: gzip, zstd, none" << std::endl;
+                    return false;
+                }
+                options.compression_given = true;
+                if (options.compression != Compression::None && !compression_supported(options.compression)) {
+                    std::cerr << "Error: This build has no " << codec << " support" << std::endl;
+                    return false;
+                }
+                break;
+            }
+            case 'F':
+                if (!parse_field_list(optarg, options.fields)) {
+                    std::cerr << "Error: Invalid field list '" << optarg << "'. Valid fields are: ";
+                    for (size_t i = 0; i < BusinessFields::FIELD_COUNT; ++i) {
+                        std::cerr << (i > 0 ? ", " : "") << BusinessFields::FIELDS[i].key;
+                    }
+                    std::cerr << std::endl;
+                    return false;
+                }
+                break;
+            case 'i':
+                options.incremental = true;
+                break;
+            case 'b':
+                options.batch_filename = optarg;
+                break;
+            case 'j':
+                options.max_concurrency = std::atoi(optarg);
+                if (options.max_concurrency <= 0) {
+                    std::cerr << "Error: Concurrency must be a positive number" << std::endl;
+                    return false;
+                }
+                break;
+            case 'c':
+                options.checkpoint_filename = optarg;
+                break;
+            case 'm':
+                options.metrics_filename = optarg;
+                break;
+            case 'M': {
+                int megabytes = std::atoi(optarg);
+                if (megabytes <= 0) {
+                    std::cerr << "Error: Memory budget must be a positive number of megabytes" << std::endl;
+                    return false;
+                }
+                options.memory_budget_bytes = static_cast<size_t>(megabytes) * 1024 * 1024;
+                break;
+            }
+            case 't':
+                options.trace_filename = optarg;
+                break;
+            case 'L':
+                options.load_filename = optarg;
+                break;
+            case 'D':
+                options.diff_filename = optarg;
+                break;
+            case 'R':
+                options.refresh_filename = optarg;
+                break;
+            case 'T':
+                options.refresh_ttl_hours = std::atoi(optarg);
+                if (options.refresh_ttl_hours < 0) {
+                    std::cerr << "Error: TTL must be zero or a positive number of hours" << std::endl;
+                    return false;
+                }
+                break;
+            case 'S':
+                options.store_filename = optarg;
+                break;
+            case 'Q':
+                if (!parse_store_filter(optarg, options.store_query)) {
+                    std::cerr << "Error: Invalid query '" << optarg << "'. Use name=PREFIX, phone=NUMBER or domain=DOMAIN" << std::endl;
+                    return false;
+                }
+                options.query_store = true;
+                break;
+            case 'u':
+                options.search_options.merge_duplicates = true;
+                break;
+            case 's':
+                options.search_options.merge_similar_names = true;
+                break;
+            case 'P':
+                options.search_options.merge_nearby_meters = std::atof(optarg);
+                if (options.search_options.merge_nearby_meters <= 0.0) {
+                    std::cerr << "Error: Merge distance must be a positive number of meters" << std::endl;
+                    return false;
+                }
+                break;
             case 'n':
                 options.search_options.enhance_with_web_scraping = false;
                 break;
@@ -205,12 +553,244 @@ bool parse_command_line(int argc, char** argv, ProgramOptions& options) {
         }
     }
 
+    if (options.binary_output && options.compression != Compression::None) {
+        std::cerr << "Error: --compress applies to text formats, not binary records" << std::endl;
+        return false;
+    }
+
+    if (!options.fields.empty() && (options.binary_output || options.parquet_output)) {
+        std::cerr << "Error: --fields applies to text formats; binary and Parquet files keep every field" << std::endl;
+        return false;
+    }
+
+    if (options.incremental) {
+        if (options.binary_output || options.parquet_output) {
+            std::cerr << "Error: --incremental applies to text formats" << std::endl;
+            return false;
+        }
+        if (!options.load_filename.empty() || !options.refresh_filename.empty() || options.query_store) {
+            std::cerr << "Error: --incremental applies to searches and batches" << std::endl;
+            return false;
+        }
+        if (options.search_options.merge_duplicates || options.search_options.merge_similar_names ||
+            options.search_options.merge_nearby_meters > 0.0) {
+            std::cerr << "Error: --incremental cannot be combined with merging, which needs every result first" << std::endl;
+            return false;
+        }
+    }
+
+    // Text outputs carry no place IDs or fetch times, so nothing in them could be matched or reused
+    if (!options.refresh_filename.empty()) {
+        std::string extension = std::filesystem::path(options.refresh_filename).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension != std::string(".") + RecordFile::EXTENSION && extension != std::string(".") + ResultStoreFile::EXTENSION) {
+            std::cerr << "Error: --refresh needs a binary record file (." << RecordFile::EXTENSION << ") or a result store (."
+                      << ResultStoreFile::EXTENSION << "); JSON and other text outputs have no place IDs to refresh by" << std::endl;
+            return false;
+        }
+    }
+
+    if (options.query_store && options.store_filename.empty()) {
+        std::cerr << "Error: --query needs the --store to read from" << std::endl;
+        return false;
+    }
+
     // Check required arguments
-    if (options.search_options.keyword.empty() || options.search_options.location.empty()) {
+    if (options.batch_filename.empty() && options.load_filename.empty() && !options.query_store &&
+        (options.search_options.keyword.empty() || options.search_options.location.empty())) {
         std::cerr << "Error: Both --keyword and --location are required\n" << std::endl;
         print_usage(argv[0]);
         return false;
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+bool load_batch_jobs(const std::string& filename, const SearchOptions& defaults, std::vector<SearchOptions>& jobs) {
+    std::vector<std::vector<std::string>> rows;
+    std::vector<size_t> line_numbers;
+    if (!FileUtils::read_csv_file(filename, rows, &line_numbers)) {
+        std::cerr << "Error: Could not read batch file: " << FileUtils::last_error() << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& row = rows[i];
+
+        // Skip an optional header row
+        if (i == 0 && !row.empty()) {
+            std::string first = row[0];
+            std::transform(first.begin(), first.end(), first.begin(), ::tolower);
+            if (first == "keyword") {
+                continue;
+            }
+        }
+
+        if (row.size() < 2 || row[0].empty() || row[1].empty()) {
+            std::cerr << "Error: Batch file line " << line_numbers[i] << " needs at least a keyword and a location" << std::endl;
+            return false;
+        }
+
+        SearchOptions job = defaults;
+        job.keyword = row[0];
+        job.location = row[1];
+        if (row.size() > 2 && !row[2].empty()) {
+            job.max_radius = std::atoi(row[2].c_str());
+        }
+        if (row.size() > 3 && !row[3].empty()) {
+            job.max_results = std::atoi(row[3].c_str());
+        }
+
+        if (job.max_radius <= 0 || job.max_results <= 0) {
+            std::cerr << "Error: Batch file line " << line_numbers[i] << " has an invalid distance or result count" << std::endl;
+            return false;
+        }
+
+        jobs.push_back(job);
+    }
+
+    if (jobs.empty()) {
+        std::cerr << "Error: Batch file contains no jobs: " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool parse_store_filter(const std::string& filter, StoreQuery& query) {
+    size_t separator = filter.find('=');
+    if (separator == std::string::npos || separator + 1 == filter.size()) {
+        return false;
+    }
+
+    std::string field = filter.substr(0, separator);
+    std::transform(field.begin(), field.end(), field.begin(), ::tolower);
+    std::string value = filter.substr(separator + 1);
+
+    if (field == "name") {
+        query.name = value;
+    } else if (field == "phone") {
+        query.phone = value;
+    } else if (field == "domain" || field == "website") {
+        query.domain = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Comma-separated field keys, each at most once; spaces around keys are ignored
+bool parse_field_list(const std::string& list, std::vector<BusinessFields::FieldId>& fields) {
+    fields.clear();
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+
+        std::string key = list.substr(start, end - start);
+        key.erase(0, key.find_first_not_of(' '));
+        key.erase(key.find_last_not_of(' ') + 1);
+        std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+        BusinessFields::FieldId id;
+        if (!BusinessFields::find_field(key, id) || std::find(fields.begin(), fields.end(), id) != fields.end()) {
+            return false;
+        }
+        fields.push_back(id);
+        start = end + 1;
+    }
+    return !fields.empty();
+}
+
+bool save_results(const BusinessScraperEngine& engine, const SearchResults& results, const ProgramOptions& options,
+                  const std::string& filename, std::string& error_message) {
+    if (options.binary_output) {
+        return engine.save_records(results, filename, error_message);
+    }
+    if (options.parquet_output) {
+        // Parquet compresses each page itself; --compress picks the codec
+        Compression codec = options.compression_given ? options.compression : Compression::Gzip;
+        return engine.save_parquet(results, filename, error_message, codec);
+    }
+
+    return engine.save_results(results, options.output_format, filename, error_message, options.compression);
+}
+
+bool write_diff(const BusinessScraperEngine& engine, const SearchResults& results, const ProgramOptions& options,
+                const std::string& output_filename) {
+    SearchResults previous = engine.load_results(options.diff_filename);
+    if (!previous.success) {
+        std::cerr << "Diff failed: " << previous.error_message << std::endl;
+        return false;
+    }
+
+    ResultDiff diff;
+    std::string error_message;
+    if (!engine.diff_results(previous, results, diff, error_message)) {
+        std::cerr << "Diff failed: " << error_message << std::endl;
+        return false;
+    }
+
+    std::cout << "Changes since '" << options.diff_filename << "': " << diff.added.size() << " added, "
+              << diff.removed.size() << " removed, " << diff.changed.size() << " changed, "
+              << diff.unchanged << " unchanged." << std::endl;
+
+    // Each non-empty change set goes next to the output: results.added.csv, ...
+    // (results.added.csv.gz when compressed)
+    std::filesystem::path output_path(output_filename);
+    std::string compression_suffix;
+    if (options.compression != Compression::None && !options.parquet_output) {
+        compression_suffix = output_path.extension().string();
+        output_path.replace_extension();
+    }
+    std::pair<const char*, std::vector<Business>*> change_sets[] = {
+        {"added", &diff.added}, {"removed", &diff.removed}, {"changed", &diff.changed}
+    };
+    for (auto& change_set : change_sets) {
+        if (change_set.second->empty()) continue;
+
+        SearchResults part;
+        part.success = true;
+        part.businesses = std::move(*change_set.second);
+        part.total_found = static_cast<int>(part.businesses.size());
+
+        std::filesystem::path part_path = output_path;
+        part_path.replace_filename(output_path.stem().string() + "." + change_set.first +
+                                   output_path.extension().string() + compression_suffix);
+        if (!save_results(engine, part, options, part_path.string(), error_message)) {
+            std::cerr << "Error saving " << change_set.first << " records: " << error_message << std::endl;
+            return false;
+        }
+        std::cout << "Saved " << part.businesses.size() << " " << change_set.first << " records to: "
+                  << part_path.string() << std::endl;
+    }
+    return true;
+}
+
+void write_metrics(const BusinessScraperEngine& engine, const std::string& filename) {
+    if (filename.empty()) {
+        return;
+    }
+
+    MetricsSnapshot snapshot = engine.metrics_snapshot();
+    bool prometheus = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".prom") == 0;
+
+    if (FileUtils::write_to_file(prometheus ? snapshot.to_prometheus() : snapshot.to_json(), filename)) {
+        std::cout << "Metrics saved to: " << filename << std::endl;
+    } else {
+        std::cerr << "Error saving metrics: " << FileUtils::last_error() << std::endl;
+    }
+}
+
+void write_trace(const std::string& filename) {
+    if (filename.empty()) {
+        return;
+    }
+
+    Tracer::stop();
+    if (Tracer::write_chrome_trace(filename)) {
+        std::cout << "Trace saved to: " << filename << std::endl;
+    } else {
+        std::cerr << "Error saving trace: " << Tracer::last_error() << std::endl;
+    }
+}
@@ -0,0 +1,234 @@
+#include "output/CompressedSink.h"
+#include <algorithm>
+#include <climits>
+#include <zlib.h>
+
+#ifdef BUSINESS_SCRAPER_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+    constexpr size_t OUTPUT_CHUNK_SIZE = 256 * 1024;
+    constexpr int DEFAULT_GZIP_LEVEL = 3;
+}
+
+const char* compression_extension(Compression compression) {
+    switch (compression) {
+        case Compression::Gzip: return "gz";
+        case Compression::Zstd: return "zst";
+        case Compression::None:
+        default: return "";
+    }
+}
+
+bool compression_supported(Compression compression) {
+    switch (compression) {
+        case Compression::Gzip:
+            return true;
+        case Compression::Zstd:
+#ifdef BUSINESS_SCRAPER_ZSTD
+            return true;
+#else
+            return false;
+#endif
+        case Compression::None:
+        default:
+            return false;
+    }
+}
+
+// One codec's streaming state. step() consumes what it can of the input and
+// fills what it can of the output, advancing both; with end set it also
+// flushes the stream and reports done once the last byte is out.
+class CompressionCodec {
+public:
+    virtual ~CompressionCodec() {}
+    virtual bool step(const char*& in, size_t& in_left, char*& out, size_t& out_left, bool end, bool& done,
+                      std::string& error) = 0;
+};
+
+namespace {
+    class GzipCodec : public CompressionCodec {
+    public:
+        explicit GzipCodec(int level)
+            : m_initialized(false)
+        {
+            m_stream = z_stream();
+            // 16 added to the window bits selects a gzip header and trailer over raw zlib
+            m_initialized = deflateInit2(&m_stream, level > 0 ? level : DEFAULT_GZIP_LEVEL, Z_DEFLATED,
+                                         15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        }
+
+        ~GzipCodec() override {
+            if (m_initialized) {
+                deflateEnd(&m_stream);
+            }
+        }
+
+        bool initialized() const { return m_initialized; }
+
+        bool step(const char*& in, size_t& in_left, char*& out, size_t& out_left, bool end, bool& done,
+                  std::string& error) override {
+            // zlib counts in uInt; larger inputs are consumed over several steps
+            uInt in_size = static_cast<uInt>(std::min<size_t>(in_left, UINT_MAX));
+            uInt out_size = static_cast<uInt>(std::min<size_t>(out_left, UINT_MAX));
+            m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+            m_stream.avail_in = in_size;
+            m_stream.next_out = reinterpret_cast<Bytef*>(out);
+            m_stream.avail_out = out_size;
+
+            // Z_BUF_ERROR only means no progress was possible this call
+            int result = deflate(&m_stream, end && in_size == in_left ? Z_FINISH : Z_NO_FLUSH);
+            if (result == Z_STREAM_ERROR) {
+                error = "gzip compression failed";
+                return false;
+            }
+
+            in += in_size - m_stream.avail_in;
+            in_left -= in_size - m_stream.avail_in;
+            out += out_size - m_stream.avail_out;
+            out_left -= out_size - m_stream.avail_out;
+            done = result == Z_STREAM_END;
+            return true;
+        }
+
+    private:
+        z_stream m_stream;
+        bool m_initialized;
+    };
+
+#ifdef BUSINESS_SCRAPER_ZSTD
+    class ZstdCodec : public CompressionCodec {
+    public:
+        explicit ZstdCodec(int level)
+            : m_context(ZSTD_createCCtx())
+        {
+            // Level 0 is zstd's own default, 3
+            if (m_context && ZSTD_isError(ZSTD_CCtx_setParameter(m_context, ZSTD_c_compressionLevel, level))) {
+                ZSTD_freeCCtx(m_context);
+                m_context = nullptr;
+            }
+        }
+
+        ~ZstdCodec() override {
+            ZSTD_freeCCtx(m_context);
+        }
+
+        bool initialized() const { return m_context != nullptr; }
+
+        bool step(const char*& in, size_t& in_left, char*& out, size_t& out_left, bool end, bool& done,
+                  std::string& error) override {
+            ZSTD_inBuffer input = {in, in_left, 0};
+            ZSTD_outBuffer output = {out, out_left, 0};
+
+            // With ZSTD_e_end the return value is the number of bytes still to flush
+            size_t result = ZSTD_compressStream2(m_context, &output, &input, end ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(result)) {
+                error = std::string("zstd compression failed: ") + ZSTD_getErrorName(result);
+                return false;
+            }
+
+            in += input.pos;
+            in_left -= input.pos;
+            out += output.pos;
+            out_left -= output.pos;
+            done = end && result == 0;
+            return true;
+        }
+
+    private:
+        ZSTD_CCtx* m_context;
+    };
+#endif
+}
+
+CompressedSink::CompressedSink(OutputSink& target, Compression compression, int level, size_t buffer_size)
+    : OutputSink(buffer_size)
+    , m_target(target)
+    , m_out(new char[OUTPUT_CHUNK_SIZE])
+    , m_bytes_in(0)
+    , m_bytes_out(0)
+    , m_finished(false)
+{
+    switch (compression) {
+        case Compression::Gzip: {
+            auto codec = std::make_unique<GzipCodec>(level);
+            if (codec->initialized()) m_codec = std::move(codec);
+            break;
+        }
+#ifdef BUSINESS_SCRAPER_ZSTD
+        case Compression::Zstd: {
+            auto codec = std::make_unique<ZstdCodec>(level);
+            if (codec->initialized()) m_codec = std::move(codec);
+            break;
+        }
+#endif
+        default:
+            set_error("Compression is not supported by this build");
+            return;
+    }
+
+    if (!m_codec) {
+        set_error("Could not initialize compression");
+    }
+}
+
+CompressedSink::~CompressedSink() {
+    if (!m_finished) {
+        finish();
+    }
+}
+
+bool CompressedSink::finish() {
+    if (m_finished) {
+        return ok();
+    }
+
+    flush();
+    if (ok()) {
+        compress(nullptr, 0, true);
+    }
+    m_finished = true;
+    return ok();
+}
+
+bool CompressedSink::write_through(const char* data, size_t size) {
+    if (m_finished) {
+        set_error("Write after the compressed stream was finished");
+        return false;
+    }
+    m_bytes_in += size;
+    return compress(data, size, false);
+}
+
+bool CompressedSink::compress(const char* data, size_t size, bool end) {
+    if (!m_codec) {
+        return false;
+    }
+
+    for (;;) {
+        char* out = m_out.get();
+        size_t out_left = OUTPUT_CHUNK_SIZE;
+        bool done = false;
+        std::string error;
+        if (!m_codec->step(data, size, out, out_left, end, done, error)) {
+            set_error(error);
+            return false;
+        }
+
+        size_t produced = OUTPUT_CHUNK_SIZE - out_left;
+        if (produced > 0) {
+            m_target.write(m_out.get(), produced);
+            m_bytes_out += produced;
+            if (!m_target.ok()) {
+                set_error(m_target.last_error());
+                return false;
+            }
+        }
+
+        // A full output chunk may leave more pending inside the codec
+        if (end ? done : size == 0 && out_left > 0) {
+            return true;
+        }
+    }
+}
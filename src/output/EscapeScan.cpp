@@ -0,0 +1,154 @@
+#include "output/EscapeScan.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#define ESCAPE_SCAN_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ESCAPE_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    inline unsigned first_set_bit(unsigned mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    // Byte-class predicates, each with a scalar test and a vector test giving
+    // 0xFF in every matching lane
+    struct JsonBytes {
+        static bool match(unsigned char c) { return c < 0x20 || c == '"' || c == '\\'; }
+#if ESCAPE_SCAN_AVX2
+        static __m256i match(__m256i v) {
+            // Unsigned v <= 0x1F, as min(v, 0x1F) == v
+            __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+            return _mm256_or_si256(control, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))));
+        }
+#elif ESCAPE_SCAN_SSE2
+        static __m128i match(__m128i v) {
+            __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v);
+            return _mm_or_si128(control, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                                      _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))));
+        }
+#endif
+    };
+
+    struct XmlBytes {
+        static bool match(unsigned char c) { return c == '<' || c == '>' || c == '&' || c == '"' || c == '\''; }
+#if ESCAPE_SCAN_AVX2
+        static __m256i match(__m256i v) {
+            __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('<')),
+                                               _mm256_cmpeq_epi8(v, _mm256_set1_epi8('>')));
+            __m256i quotes = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                             _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')));
+            return _mm256_or_si256(_mm256_or_si256(brackets, quotes), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('&')));
+        }
+#elif ESCAPE_SCAN_SSE2
+        static __m128i match(__m128i v) {
+            __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('<')),
+                                            _mm_cmpeq_epi8(v, _mm_set1_epi8('>')));
+            __m128i quotes = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                          _mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+            return _mm_or_si128(_mm_or_si128(brackets, quotes), _mm_cmpeq_epi8(v, _mm_set1_epi8('&')));
+        }
+#endif
+    };
+
+    struct CsvBytes {
+        static bool match(unsigned char c) { return c == ',' || c == '"' || c == '\n'; }
+#if ESCAPE_SCAN_AVX2
+        static __m256i match(__m256i v) {
+            return _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')),
+                                                   _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))),
+                                   _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+        }
+#elif ESCAPE_SCAN_SSE2
+        static __m128i match(__m128i v) {
+            return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(',')),
+                                             _mm_cmpeq_epi8(v, _mm_set1_epi8('"'))),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+        }
+#endif
+    };
+
+    struct QuoteBytes {
+        static bool match(unsigned char c) { return c == '"'; }
+#if ESCAPE_SCAN_AVX2
+        static __m256i match(__m256i v) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')); }
+#elif ESCAPE_SCAN_SSE2
+        static __m128i match(__m128i v) { return _mm_cmpeq_epi8(v, _mm_set1_epi8('"')); }
+#endif
+    };
+
+#if ESCAPE_SCAN_AVX2
+    constexpr size_t WIDTH = 32;
+    inline unsigned match_mask(const char* data, __m256i (*match)(__m256i)) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        return static_cast<unsigned>(_mm256_movemask_epi8(match(chunk)));
+    }
+#elif ESCAPE_SCAN_SSE2
+    constexpr size_t WIDTH = 16;
+    inline unsigned match_mask(const char* data, __m128i (*match)(__m128i)) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        return static_cast<unsigned>(_mm_movemask_epi8(match(chunk)));
+    }
+#endif
+
+    template <typename Bytes>
+    size_t scan(const char* data, size_t size) {
+#if ESCAPE_SCAN_AVX2 || ESCAPE_SCAN_SSE2
+        size_t i = 0;
+        for (; i + WIDTH <= size; i += WIDTH) {
+            unsigned mask = match_mask(data + i, Bytes::match);
+            if (mask != 0) return i + first_set_bit(mask);
+        }
+        if (i == size) return size;
+
+        // The tail is tested with one more vector instead of byte by byte: an
+        // overlapping load ending at the last byte, ignoring lanes already
+        // tested, or for short input a zero-padded copy, ignoring the padding
+        if (size >= WIDTH) {
+            size_t start = size - WIDTH;
+            unsigned mask = match_mask(data + start, Bytes::match) >> (i - start);
+            return mask != 0 ? i + first_set_bit(mask) : size;
+        }
+        alignas(WIDTH) char padded[WIDTH] = {};
+        std::memcpy(padded, data, size);
+        unsigned mask = match_mask(padded, Bytes::match) & ((1u << size) - 1);
+        return mask != 0 ? first_set_bit(mask) : size;
+#else
+        for (size_t i = 0; i < size; ++i) {
+            if (Bytes::match(static_cast<unsigned char>(data[i]))) return i;
+        }
+        return size;
+#endif
+    }
+}
+
+namespace EscapeScan {
+    size_t find_json(const char* data, size_t size) { return scan<JsonBytes>(data, size); }
+    size_t find_xml(const char* data, size_t size) { return scan<XmlBytes>(data, size); }
+    size_t find_csv(const char* data, size_t size) { return scan<CsvBytes>(data, size); }
+    size_t find_quote(const char* data, size_t size) { return scan<QuoteBytes>(data, size); }
+
+    const char* implementation() {
+#if ESCAPE_SCAN_AVX2
+        return "avx2";
+#elif ESCAPE_SCAN_SSE2
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+}
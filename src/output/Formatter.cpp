@@ -1,256 +1,459 @@
 #include "output/Formatter.h"
-#include <sstream>
-#include <iomanip>
+#include "output/EscapeScan.h"
+#include "core/BusinessFields.h"
 #include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // Shortest text that reads back as the same double ("4.5", "0.1", "1e-07").
+    // to_chars never consults the C locale, so a comma decimal separator (as
+    // the GUI picks up on a de_DE host) cannot leak into CSV or JSON, and it
+    // neither parses a format string nor allocates.
+    void write_number(OutputSink& sink, double value) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        sink.write(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+
+    void write_number(OutputSink& sink, int value) {
+        char buffer[16];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        sink.write(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+
+    const char* json_escape(char c) {
+        switch (c) {
+            case '"': return "\\\"";
+            case '\\': return "\\\\";
+            case '\b': return "\\b";
+            case '\f': return "\\f";
+            case '\n': return "\\n";
+            case '\r': return "\\r";
+            case '\t': return "\\t";
+            default: return nullptr;
+        }
+    }
+
+    const char* xml_escape(char c) {
+        switch (c) {
+            case '<': return "&lt;";
+            case '>': return "&gt;";
+            case '&': return "&amp;";
+            case '"': return "&quot;";
+            case '\'': return "&apos;";
+            default: return nullptr;
+        }
+    }
+
+    // Copies each clean run with one write and replaces the characters escape()
+    // maps; find() locates candidates a vector at a time (see EscapeScan)
+    template <typename Find, typename Escape>
+    void write_escaped(OutputSink& sink, std::string_view text, Find find, Escape escape) {
+        const char* data = text.data();
+        const size_t size = text.size();
+        size_t run_start = 0;
+        size_t i = 0;
+        while ((i += find(data + i, size - i)) < size) {
+            if (const char* replacement = escape(data[i])) {
+                sink.write(data + run_start, i - run_start);
+                sink.write(std::string_view(replacement));
+                run_start = i + 1;
+            }
+            ++i;
+        }
+        sink.write(data + run_start, size - run_start);
+    }
+
+    bool needs_csv_quotes(std::string_view field) {
+        return EscapeScan::find_csv(field.data(), field.size()) < field.size();
+    }
+
+    void write_csv_quoted(OutputSink& sink, std::string_view field) {
+        // Escape quotes by doubling them
+        write_escaped(sink, field, EscapeScan::find_quote, [](char) { return "\"\""; });
+    }
+}
 
 Formatter::Formatter()
     : m_format(OutputFormat::CSV)
+    , m_threads(0)
 {}
 
 Formatter::Formatter(OutputFormat format)
     : m_format(format)
+    , m_threads(0)
 {}
 
 Formatter::~Formatter() {}
 
 std::string Formatter::format_businesses(const std::vector<Business>& businesses) const {
+    std::string output;
+    StringSink sink(output);
+
+    begin(sink);
+    write_records(sink, businesses);
+    end(sink, businesses.size());
+
+    sink.flush();
+    return output;
+}
+
+void Formatter::begin(OutputSink& sink) const {
     switch (m_format) {
-        case OutputFormat::CSV:
-            return format_as_csv(businesses);
         case OutputFormat::JSON:
-            return format_as_json(businesses);
+            sink.write("{\n  \"businesses\": [\n");
+            break;
         case OutputFormat::YAML:
-            return format_as_yaml(businesses);
+            sink.write("businesses:\n");
+            break;
         case OutputFormat::XML:
-            return format_as_xml(businesses);
+            sink.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                       "<businesses>\n");
+            break;
+        case OutputFormat::JSONL:
+            // No header: every line stands alone, so files can be appended to
+            break;
+        case OutputFormat::CSV:
         default:
-            return format_as_csv(businesses);
+            write_csv_header(sink);
+            break;
     }
 }
 
-std::string Formatter::format_as_csv(const std::vector<Business>& businesses) const {
-    std::ostringstream oss;
-
-    // CSV Header
-    oss << "Name,Address,Phone Number,Email,Website,Rating,Total Ratings,Additional Numbers,Additional Emails,Social Media Links\n";
-
-    // CSV Data
-    for (const auto& business : businesses) {
-        oss << escape_csv_field(business.name()) << ","
-            << escape_csv_field(business.address()) << ","
-            << escape_csv_field(business.phone_number()) << ","
-            << escape_csv_field(business.email()) << ","
-            << escape_csv_field(business.website()) << ","
-            << business.rating() << ","
-            << business.total_ratings() << ","
-            << escape_csv_field(vector_to_string(business.additional_numbers())) << ","
-            << escape_csv_field(vector_to_string(business.additional_emails())) << ","
-            << escape_csv_field(vector_to_string(business.social_media_links())) << "\n";
+void Formatter::write_record(OutputSink& sink, const Business& business, size_t index) const {
+    switch (m_format) {
+        case OutputFormat::JSON:
+            // Separator goes before every record but the first, so records can be streamed
+            if (index > 0) sink.write(",\n");
+            write_json_record(sink, business);
+            break;
+        case OutputFormat::YAML:
+            write_yaml_record(sink, business);
+            break;
+        case OutputFormat::XML:
+            write_xml_record(sink, business);
+            break;
+        case OutputFormat::JSONL:
+            write_jsonl_record(sink, business);
+            break;
+        case OutputFormat::CSV:
+        default:
+            write_csv_record(sink, business);
+            break;
     }
-
-    return oss.str();
 }
 
-std::string Formatter::format_as_json(const std::vector<Business>& businesses) const {
-    std::ostringstream oss;
+size_t Formatter::effective_threads() const {
+    if (m_threads > 0) return m_threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
 
-    oss << "{\n  \"businesses\": [\n";
+// Records carry their global index into whichever chunk formats them, so JSON
+// separators come out as in the serial path, and the document framing is
+// left to begin() and end(). Workers claim chunks in order and may run at
+// most a window of chunks ahead of the writer, which bounds the memory held
+// in chunk buffers whatever the input size.
+void Formatter::write_records(OutputSink& sink, const std::vector<Business>& businesses, size_t first_index) const {
+    const size_t count = businesses.size();
+    const size_t chunk_count = (count + CHUNK_RECORDS - 1) / CHUNK_RECORDS;
+    const size_t worker_count = std::min(effective_threads(), chunk_count);
+
+    if (chunk_count < 2 || worker_count < 2) {
+        for (size_t i = 0; i < count; ++i) {
+            write_record(sink, businesses[i], first_index + i);
+        }
+        return;
+    }
 
-    for (size_t i = 0; i < businesses.size(); ++i) {
-        const auto& business = businesses[i];
+    const size_t window = worker_count * 2;
+    std::vector<std::string> buffers(window);
+    std::vector<size_t> ready(window, chunk_count);  // chunk last completed in each buffer
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next_chunk = 0;
+    size_t chunks_written = 0;
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return next_chunk >= chunk_count || next_chunk < chunks_written + window; });
+                if (next_chunk >= chunk_count) return;
+                chunk = next_chunk++;
+            }
 
-        oss << "    {\n"
-            << "      \"name\": \"" << escape_json_string(business.name()) << "\",\n"
-            << "      \"address\": \"" << escape_json_string(business.address()) << "\",\n"
-            << "      \"phone_number\": \"" << escape_json_string(business.phone_number()) << "\",\n"
-            << "      \"email\": \"" << escape_json_string(business.email()) << "\",\n"
-            << "      \"website\": \"" << escape_json_string(business.website()) << "\",\n"
-            << "      \"rating\": " << business.rating() << ",\n"
-            << "      \"total_ratings\": " << business.total_ratings() << ",\n"
-            << "      \"additional_numbers\": [";
+            // The buffer is ours until the writer has consumed this chunk
+            std::string& text = buffers[chunk % window];
+            text.clear();
+            {
+                StringSink chunk_sink(text);
+                const size_t end = std::min(count, (chunk + 1) * CHUNK_RECORDS);
+                for (size_t i = chunk * CHUNK_RECORDS; i < end; ++i) {
+                    write_record(chunk_sink, businesses[i], first_index + i);
+                }
+            }
 
-        const auto& numbers = business.additional_numbers();
-        for (size_t j = 0; j < numbers.size(); ++j) {
-            oss << "\"" << escape_json_string(numbers[j]) << "\"";
-            if (j < numbers.size() - 1) oss << ", ";
+            std::lock_guard<std::mutex> lock(mutex);
+            ready[chunk % window] = chunk;
+            changed.notify_all();
         }
+    };
 
-        oss << "],\n      \"additional_emails\": [";
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
 
-        const auto& emails = business.additional_emails();
-        for (size_t j = 0; j < emails.size(); ++j) {
-            oss << "\"" << escape_json_string(emails[j]) << "\"";
-            if (j < emails.size() - 1) oss << ", ";
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return ready[chunk % window] == chunk; });
         }
+        sink.write(buffers[chunk % window]);
 
-        oss << "],\n      \"social_media_links\": [";
-
-        const auto& social = business.social_media_links();
-        for (size_t j = 0; j < social.size(); ++j) {
-            oss << "\"" << escape_json_string(social[j]) << "\"";
-            if (j < social.size() - 1) oss << ", ";
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!sink.ok()) {
+            // Nothing more can be written; stop handing out chunks
+            next_chunk = chunk_count;
         }
+        chunks_written = chunk + 1;
+        changed.notify_all();
+        if (!sink.ok()) break;
+    }
 
-        oss << "]\n    }";
-        if (i < businesses.size() - 1) oss << ",";
-        oss << "\n";
+    for (auto& thread : workers) {
+        thread.join();
     }
+}
 
-    oss << "  ]\n}";
+void Formatter::end(OutputSink& sink, size_t record_count) const {
+    switch (m_format) {
+        case OutputFormat::JSON:
+            if (record_count > 0) sink.put('\n');
+            sink.write("  ]\n}");
+            break;
+        case OutputFormat::XML:
+            sink.write("</businesses>");
+            break;
+        case OutputFormat::YAML:
+        case OutputFormat::JSONL:
+        case OutputFormat::CSV:
+        default:
+            break;
+    }
+}
 
-    return oss.str();
+// With every field selected the visitor is unrolled over the whole field list;
+// a projection looks each selected field up by id and runs the same code.
+template <typename Visitor>
+void Formatter::for_each_selected(Visitor&& visit) const {
+    if (m_fields.empty()) {
+        BusinessFields::for_each_field(visit);
+        return;
+    }
+    for (BusinessFields::FieldId id : m_fields) {
+        BusinessFields::visit_field(id, visit);
+    }
 }
 
-std::string Formatter::format_as_yaml(const std::vector<Business>& businesses) const {
-    std::ostringstream oss;
-
-    oss << "businesses:\n";
-
-    for (const auto& business : businesses) {
-        oss << "  - name: \"" << business.name() << "\"\n"
-            << "    address: \"" << business.address() << "\"\n"
-            << "    phone_number: \"" << business.phone_number() << "\"\n"
-            << "    email: \"" << business.email() << "\"\n"
-            << "    website: \"" << business.website() << "\"\n"
-            << "    rating: " << business.rating() << "\n"
-            << "    total_ratings: " << business.total_ratings() << "\n";
-
-        const auto& numbers = business.additional_numbers();
-        if (!numbers.empty()) {
-            oss << "    additional_numbers:\n";
-            for (const auto& number : numbers) {
-                oss << "      - \"" << number << "\"\n";
-            }
+void Formatter::write_csv_header(OutputSink& sink) const {
+    bool first = true;
+    for_each_selected([&](auto field) {
+        if (!first) sink.put(',');
+        first = false;
+        sink.write(decltype(field)::label);
+    });
+    sink.put('\n');
+}
+
+// Each record writer visits the selected fields of BusinessFields in order;
+// the field types are known at compile time, so every field compiles to
+// straight-line code for its type.
+void Formatter::write_csv_record(OutputSink& sink, const Business& business) const {
+    bool first = true;
+    for_each_selected([&](auto field) {
+        using Field = decltype(field);
+        const auto& value = Field::get(business);
+        if (!first) sink.put(',');
+        first = false;
+
+        if constexpr (Field::type == BusinessFields::FieldType::String) {
+            write_csv_field(sink, value);
+        } else if constexpr (Field::type == BusinessFields::FieldType::StringList) {
+            write_csv_list(sink, value);
         } else {
-            oss << "    additional_numbers: []\n";
+            write_number(sink, value);
         }
+    });
+    sink.put('\n');
+}
 
-        const auto& emails = business.additional_emails();
-        if (!emails.empty()) {
-            oss << "    additional_emails:\n";
-            for (const auto& email : emails) {
-                oss << "      - \"" << email << "\"\n";
-            }
+void Formatter::write_json_record(OutputSink& sink, const Business& business) const {
+    sink.write("    {\n");
+    bool first = true;
+    for_each_selected([&](auto field) {
+        using Field = decltype(field);
+        const auto& value = Field::get(business);
+        sink.write(first ? "      \"" : ",\n      \"");
+        first = false;
+        sink.write(Field::key);
+        sink.write("\": ");
+
+        if constexpr (Field::type == BusinessFields::FieldType::String) {
+            sink.put('"');
+            write_json_string(sink, value);
+            sink.put('"');
+        } else if constexpr (Field::type == BusinessFields::FieldType::StringList) {
+            sink.put('[');
+            write_json_list(sink, value);
+            sink.put(']');
         } else {
-            oss << "    additional_emails: []\n";
+            write_number(sink, value);
         }
+    });
+    sink.write("\n    }");
+}
 
-        const auto& social = business.social_media_links();
-        if (!social.empty()) {
-            oss << "    social_media_links:\n";
-            for (const auto& link : social) {
-                oss << "      - \"" << link << "\"\n";
-            }
+void Formatter::write_jsonl_record(OutputSink& sink, const Business& business) const {
+    bool first = true;
+    for_each_selected([&](auto field) {
+        using Field = decltype(field);
+        const auto& value = Field::get(business);
+        sink.write(first ? "{\"" : ",\"");
+        first = false;
+        sink.write(Field::key);
+        sink.write("\":");
+
+        if constexpr (Field::type == BusinessFields::FieldType::String) {
+            sink.put('"');
+            write_json_string(sink, value);
+            sink.put('"');
+        } else if constexpr (Field::type == BusinessFields::FieldType::StringList) {
+            sink.put('[');
+            write_json_list(sink, value, ",");
+            sink.put(']');
         } else {
-            oss << "    social_media_links: []\n";
+            write_number(sink, value);
         }
-        oss << '\n';
-    }
-
-    return oss.str();
+    });
+    sink.write("}\n");
 }
 
-std::string Formatter::format_as_xml(const std::vector<Business>& businesses) const {
-    std::ostringstream oss;
-
-    oss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
-        << "<businesses>\n";
-
-    for (const auto& business : businesses) {
-        oss << "  <business>\n"
-            << "    <name>" << escape_xml_string(business.name()) << "</name>\n"
-            << "    <address>" << escape_xml_string(business.address()) << "</address>\n"
-            << "    <phone_number>" << escape_xml_string(business.phone_number()) << "</phone_number>\n"
-            << "    <email>" << escape_xml_string(business.email()) << "</email>\n"
-            << "    <website>" << escape_xml_string(business.website()) << "</website>\n"
-            << "    <rating>" << business.rating() << "</rating>\n"
-            << "    <total_ratings>" << business.total_ratings() << "</total_ratings>\n";
-
-        oss << "    <additional_numbers>\n";
-        for (const auto& number : business.additional_numbers()) {
-            oss << "      <number>" << escape_xml_string(number) << "</number>\n";
+void Formatter::write_yaml_record(OutputSink& sink, const Business& business) const {
+    bool first = true;
+    for_each_selected([&](auto field) {
+        using Field = decltype(field);
+        const auto& value = Field::get(business);
+        sink.write(first ? "  - " : "    ");
+        first = false;
+        sink.write(Field::key);
+
+        if constexpr (Field::type == BusinessFields::FieldType::String) {
+            sink.write(": \"");
+            sink.write(value);
+            sink.write("\"\n");
+        } else if constexpr (Field::type == BusinessFields::FieldType::StringList) {
+            if (value.empty()) {
+                sink.write(": []\n");
+                return;
+            }
+            sink.write(":\n");
+            for (const auto& item : value) {
+                sink.write("      - \"");
+                sink.write(item);
+                sink.write("\"\n");
+            }
+        } else {
+            sink.write(": ");
+            write_number(sink, value);
+            sink.put('\n');
         }
-        oss << "    </additional_numbers>\n";
+    });
+    sink.put('\n');
+}
 
-        oss << "    <additional_emails>\n";
-        for (const auto& email : business.additional_emails()) {
-            oss << "      <email>" << escape_xml_string(email) << "</email>\n";
+void Formatter::write_xml_record(OutputSink& sink, const Business& business) const {
+    sink.write("  <business>\n");
+    for_each_selected([&](auto field) {
+        using Field = decltype(field);
+        const auto& value = Field::get(business);
+        sink.write("    <");
+        sink.write(Field::key);
+        sink.put('>');
+
+        if constexpr (Field::type == BusinessFields::FieldType::String) {
+            write_xml_string(sink, value);
+        } else if constexpr (Field::type == BusinessFields::FieldType::StringList) {
+            sink.put('\n');
+            for (const auto& item : value) {
+                sink.write("      <");
+                sink.write(Field::item);
+                sink.put('>');
+                write_xml_string(sink, item);
+                sink.write("</");
+                sink.write(Field::item);
+                sink.write(">\n");
+            }
+            sink.write("    ");
+        } else {
+            write_number(sink, value);
         }
-        oss << "    </additional_emails>\n";
 
-        oss << "    <social_media_links>\n";
-        for (const auto& link : business.social_media_links()) {
-            oss << "      <link>" << escape_xml_string(link) << "</link>\n";
-        }
-        oss << "    </social_media_links>\n";
+        sink.write("</");
+        sink.write(Field::key);
+        sink.write(">\n");
+    });
+    sink.write("  </business>\n");
+}
 
-        oss << "  </business>\n";
+void Formatter::write_csv_field(OutputSink& sink, std::string_view field) const {
+    if (!needs_csv_quotes(field)) {
+        sink.write(field);
+        return;
     }
-
-    oss << "</businesses>";
-
-    return oss.str();
+    sink.put('"');
+    write_csv_quoted(sink, field);
+    sink.put('"');
 }
 
-std::string Formatter::escape_csv_field(const std::string& field) const {
-    if (field.empty()) return "";
-
-    bool needs_quotes = (field.find(',') != std::string::npos ||
-                        field.find('"') != std::string::npos ||
-                        field.find('\n') != std::string::npos);
-
-    if (!needs_quotes) return field;
-
-    std::string escaped = field;
-    // Escape quotes by doubling them
-    size_t pos = 0;
-    while ((pos = escaped.find('"', pos)) != std::string::npos) {
-        escaped.insert(pos, "\"");
-        pos += 2;
+// The list is one field of ", "-joined values, quoted when it has more than one
+// value (the delimiter holds a comma) or any value needs it
+void Formatter::write_csv_list(OutputSink& sink, const std::vector<std::string>& values) const {
+    bool quoted = values.size() > 1;
+    for (size_t i = 0; i < values.size() && !quoted; ++i) {
+        quoted = needs_csv_quotes(values[i]);
     }
 
-    return "\"" + escaped + "\"";
-}
-
-std::string Formatter::escape_json_string(const std::string& str) const {
-    std::string escaped;
-    for (char c : str) {
-        switch (c) {
-            case '"': escaped += "\\\""; break;
-            case '\\': escaped += "\\\\"; break;
-            case '\b': escaped += "\\b"; break;
-            case '\f': escaped += "\\f"; break;
-            case '\n': escaped += "\\n"; break;
-            case '\r': escaped += "\\r"; break;
-            case '\t': escaped += "\\t"; break;
-            default: escaped += c; break;
+    if (quoted) sink.put('"');
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) sink.write(", ");
+        if (quoted) {
+            write_csv_quoted(sink, values[i]);
+        } else {
+            sink.write(values[i]);
         }
     }
-    return escaped;
+    if (quoted) sink.put('"');
 }
 
-std::string Formatter::escape_xml_string(const std::string& str) const {
-    std::string escaped;
-    for (char c : str) {
-        switch (c) {
-            case '<': escaped += "&lt;"; break;
-            case '>': escaped += "&gt;"; break;
-            case '&': escaped += "&amp;"; break;
-            case '"': escaped += "&quot;"; break;
-            case '\'': escaped += "&apos;"; break;
-            default: escaped += c; break;
-        }
+void Formatter::write_json_list(OutputSink& sink, const std::vector<std::string>& values, std::string_view separator) const {
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) sink.write(separator);
+        sink.put('"');
+        write_json_string(sink, values[i]);
+        sink.put('"');
     }
-    return escaped;
 }
 
-std::string Formatter::vector_to_string(const std::vector<std::string>& vec, const std::string& delimiter) const {
-    if (vec.empty()) return "";
+void Formatter::write_json_string(OutputSink& sink, std::string_view str) const {
+    write_escaped(sink, str, EscapeScan::find_json, json_escape);
+}
 
-    std::ostringstream oss;
-    for (size_t i = 0; i < vec.size(); ++i) {
-        oss << vec[i];
-        if (i < vec.size() - 1) oss << delimiter;
-    }
-    return oss.str();
-}
\ No newline at end of file
+void Formatter::write_xml_string(OutputSink& sink, std::string_view str) const {
+    write_escaped(sink, str, EscapeScan::find_xml, xml_escape);
+}
@@ -0,0 +1,136 @@
+#include "output/IncrementalWriter.h"
+#include <filesystem>
+
+IncrementalWriter::IncrementalWriter()
+    : m_sink(nullptr)
+    , m_record_count(0)
+    , m_unflushed(0)
+{}
+
+IncrementalWriter::~IncrementalWriter() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_sink) {
+        // Hand over what is buffered so the .partial file is as complete as possible
+        flush_locked();
+        m_compressed.reset();
+        m_file.close();
+    }
+}
+
+bool IncrementalWriter::open(const std::string& filename, const Formatter& formatter, Compression compression) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_sink) {
+        m_last_error = "Incremental output is already open";
+        return false;
+    }
+    m_last_error.clear();
+
+    if (!m_file.open_atomic(filename)) {
+        m_last_error = m_file.last_error();
+        return false;
+    }
+
+    m_sink = &m_file;
+    if (compression != Compression::None) {
+        m_compressed = std::make_unique<CompressedSink>(m_file, compression);
+        if (!m_compressed->ok()) {
+            m_last_error = m_compressed->last_error();
+            m_compressed.reset();
+            m_file.close();
+            m_sink = nullptr;
+            return false;
+        }
+        m_sink = m_compressed.get();
+    }
+
+    m_formatter = formatter;
+    m_record_count = 0;
+    m_unflushed = 0;
+    m_last_flush = std::chrono::steady_clock::now();
+
+    m_formatter.begin(*m_sink);
+    return flush_locked();
+}
+
+bool IncrementalWriter::write(const Business& business) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_sink || !m_last_error.empty()) {
+        return false;
+    }
+
+    m_formatter.write_record(*m_sink, business, m_record_count++);
+    if (++m_unflushed >= FLUSH_RECORDS || std::chrono::steady_clock::now() - m_last_flush >= FLUSH_INTERVAL) {
+        return flush_locked();
+    }
+    return true;
+}
+
+bool IncrementalWriter::finish() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_sink) {
+        return m_last_error.empty();
+    }
+
+    m_formatter.end(*m_sink, m_record_count);
+    if (m_compressed) {
+        if (!m_compressed->finish() && m_last_error.empty()) {
+            m_last_error = m_compressed->last_error();
+        }
+        m_compressed.reset();
+    }
+    m_sink = nullptr;
+
+    // A failed run keeps its .partial file rather than replacing a good one
+    if (!m_last_error.empty()) {
+        m_file.close();
+        return false;
+    }
+    if (!m_file.commit()) {
+        m_last_error = m_file.last_error();
+        return false;
+    }
+    return true;
+}
+
+void IncrementalWriter::discard() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_sink) {
+        return;
+    }
+
+    m_compressed.reset();
+    m_sink = nullptr;
+    m_file.close();
+
+    std::error_code error;
+    std::filesystem::remove(m_file.path(), error);
+}
+
+size_t IncrementalWriter::record_count() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_record_count;
+}
+
+std::string IncrementalWriter::partial_filename() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file.path();
+}
+
+std::string IncrementalWriter::last_error() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_last_error;
+}
+
+bool IncrementalWriter::flush_locked() {
+    m_unflushed = 0;
+    m_last_flush = std::chrono::steady_clock::now();
+
+    // Compressed output is pushed through the codec first, then to the file
+    if ((m_compressed && !m_compressed->flush()) || !m_file.flush()) {
+        if (m_last_error.empty()) {
+            m_last_error = m_compressed && !m_compressed->ok() ? m_compressed->last_error() : m_file.last_error();
+        }
+        return false;
+    }
+    return true;
+}
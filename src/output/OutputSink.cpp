@@ -0,0 +1,225 @@
+#include "output/OutputSink.h"
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+OutputSink::OutputSink(size_t buffer_size)
+    : m_buffer(new char[buffer_size > 0 ? buffer_size : 1])
+    , m_capacity(buffer_size > 0 ? buffer_size : 1)
+    , m_size(0)
+{}
+
+OutputSink::~OutputSink() {}
+
+bool OutputSink::flush() {
+    drain();
+    return ok();
+}
+
+void OutputSink::set_error(const std::string& error) {
+    if (m_last_error.empty()) {
+        m_last_error = error;
+    }
+}
+
+void OutputSink::drain() {
+    if (m_size > 0 && ok()) {
+        write_through(m_buffer.get(), m_size);
+    }
+    m_size = 0;
+}
+
+void OutputSink::write_slow(const char* data, size_t size) {
+    // Top up the buffer first so small and large writes stay in order
+    size_t room = m_capacity - m_size;
+    std::memcpy(m_buffer.get() + m_size, data, room);
+    m_size += room;
+    data += room;
+    size -= room;
+    drain();
+
+    // Anything larger than the buffer goes out without being copied
+    if (size >= m_capacity) {
+        if (ok()) {
+            write_through(data, size);
+        }
+        return;
+    }
+    std::memcpy(m_buffer.get(), data, size);
+    m_size = size;
+}
+
+StringSink::StringSink(std::string& target, size_t buffer_size)
+    : OutputSink(buffer_size)
+    , m_target(target)
+{}
+
+StringSink::~StringSink() {
+    flush();
+}
+
+bool StringSink::write_through(const char* data, size_t size) {
+    m_target.append(data, size);
+    return true;
+}
+
+StreamSink::StreamSink(std::ostream& out, size_t buffer_size)
+    : OutputSink(buffer_size)
+    , m_out(out)
+{}
+
+StreamSink::~StreamSink() {
+    flush();
+}
+
+bool StreamSink::write_through(const char* data, size_t size) {
+    if (!m_out.write(data, static_cast<std::streamsize>(size))) {
+        set_error("Error writing to stream");
+        return false;
+    }
+    return true;
+}
+
+FileSink::FileSink(size_t buffer_size)
+    : OutputSink(buffer_size)
+    , m_fd(-1)
+{}
+
+FileSink::~FileSink() {
+    if (is_open()) {
+        close();
+    }
+}
+
+bool FileSink::open(const std::string& filename) {
+    if (is_open()) {
+        close();
+    }
+    m_filename = filename;
+    m_path = filename;
+
+    std::error_code error;
+    std::filesystem::path file_path(filename);
+    if (file_path.has_parent_path()) {
+        std::filesystem::create_directories(file_path.parent_path(), error);
+    }
+
+#ifdef _WIN32
+    m_fd = ::_open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    m_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+    if (m_fd < 0) {
+        set_error("Could not create output file: " + filename);
+        return false;
+    }
+    return true;
+}
+
+bool FileSink::open_atomic(const std::string& filename) {
+    // The temporary file sits next to the target so the rename never crosses filesystems
+    if (!open(filename + PARTIAL_SUFFIX)) {
+        return false;
+    }
+    m_filename = filename;
+    return true;
+}
+
+bool FileSink::sync() {
+    if (!is_open()) {
+        set_error("Output file is not open");
+        return false;
+    }
+    if (!flush()) {
+        return false;
+    }
+#ifdef _WIN32
+    bool synced = ::_commit(m_fd) == 0;
+#else
+    bool synced = ::fsync(m_fd) == 0;
+#endif
+    if (!synced) {
+        set_error("Error syncing file: " + m_path + " (" + std::strerror(errno) + ")");
+    }
+    return synced;
+}
+
+bool FileSink::close() {
+    if (!is_open()) {
+        return ok();
+    }
+
+    bool flushed = flush();
+#ifdef _WIN32
+    bool closed = ::_close(m_fd) == 0;
+#else
+    bool closed = ::close(m_fd) == 0;
+#endif
+    m_fd = -1;
+
+    if (!closed) {
+        set_error("Error closing file: " + m_path);
+    }
+    return flushed && closed;
+}
+
+bool FileSink::commit() {
+    if (m_path == m_filename) {
+        return close();
+    }
+    if (!sync() || !close()) {
+        return false;
+    }
+
+    // rename replaces the target in one step (MoveFileEx with REPLACE_EXISTING on Windows)
+    std::error_code error;
+    std::filesystem::rename(m_path, m_filename, error);
+    if (error) {
+        set_error("Could not replace " + m_filename + ": " + error.message());
+        return false;
+    }
+    m_path = m_filename;
+
+#ifndef _WIN32
+    // The rename itself is only durable once the directory entry is synced
+    std::filesystem::path directory = std::filesystem::path(m_filename).parent_path();
+    int directory_fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (directory_fd >= 0) {
+        ::fsync(directory_fd);
+        ::close(directory_fd);
+    }
+#endif
+    return true;
+}
+
+bool FileSink::write_through(const char* data, size_t size) {
+    if (!is_open()) {
+        set_error("Output file is not open");
+        return false;
+    }
+
+    while (size > 0) {
+#ifdef _WIN32
+        int written = ::_write(m_fd, data, static_cast<unsigned int>(std::min<size_t>(size, 1 << 30)));
+#else
+        ssize_t written = ::write(m_fd, data, size);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            set_error("Error writing to file: " + m_path + " (" + std::strerror(errno) + ")");
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
@@ -0,0 +1,547 @@
+#include "output/ParquetWriter.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+    const char MAGIC[4] = {'P', 'A', 'R', '1'};
+    const char* const CREATED_BY = "business_scraper version 1.0.0";
+
+    // parquet.thrift enumerations used here
+    enum PhysicalType { TYPE_INT32 = 1, TYPE_INT64 = 2, TYPE_DOUBLE = 5, TYPE_BYTE_ARRAY = 6 };
+    enum Repetition { REQUIRED = 0, OPTIONAL = 1, REPEATED = 2 };
+    enum ConvertedType { CONVERTED_UTF8 = 0, CONVERTED_LIST = 3, CONVERTED_TIMESTAMP_MILLIS = 9 };
+    enum Encoding { ENCODING_PLAIN = 0, ENCODING_RLE = 3 };
+    enum Codec { CODEC_UNCOMPRESSED = 0, CODEC_GZIP = 2, CODEC_ZSTD = 6 };
+    enum PageType { PAGE_DATA = 0 };
+
+    enum ColumnKind {
+        STRING,      // required UTF-8 string
+        DOUBLE,      // required double
+        INT32,       // required int32
+        OPTIONAL_DOUBLE,
+        OPTIONAL_TIMESTAMP,
+        STRING_LIST  // required LIST<required string>: one definition and repetition level
+    };
+
+    struct ColumnDefinition {
+        const char* name;
+        ColumnKind kind;
+    };
+
+    // Schema order; write() appends to the columns in this order
+    const ColumnDefinition COLUMNS[] = {
+        {"place_id", STRING},
+        {"name", STRING},
+        {"address", STRING},
+        {"phone_number", STRING},
+        {"email", STRING},
+        {"website", STRING},
+        {"rating", DOUBLE},
+        {"total_ratings", INT32},
+        {"latitude", OPTIONAL_DOUBLE},
+        {"longitude", OPTIONAL_DOUBLE},
+        {"fetched_at", OPTIONAL_TIMESTAMP},  // Unix milliseconds, null when unknown
+        {"additional_numbers", STRING_LIST},
+        {"additional_emails", STRING_LIST},
+        {"social_media_links", STRING_LIST},
+    };
+    const size_t COLUMN_COUNT = sizeof(COLUMNS) / sizeof(COLUMNS[0]);
+
+    enum ColumnIndex {
+        PLACE_ID = 0, NAME, ADDRESS, PHONE, EMAIL, WEBSITE, RATING, TOTAL_RATINGS,
+        LATITUDE, LONGITUDE, FETCHED_AT, NUMBERS, EMAILS, SOCIAL
+    };
+
+    PhysicalType physical_type(ColumnKind kind) {
+        switch (kind) {
+            case DOUBLE:
+            case OPTIONAL_DOUBLE: return TYPE_DOUBLE;
+            case INT32: return TYPE_INT32;
+            case OPTIONAL_TIMESTAMP: return TYPE_INT64;
+            case STRING:
+            case STRING_LIST:
+            default: return TYPE_BYTE_ARRAY;
+        }
+    }
+
+    bool has_definition_levels(ColumnKind kind) {
+        return kind == OPTIONAL_DOUBLE || kind == OPTIONAL_TIMESTAMP || kind == STRING_LIST;
+    }
+
+    Codec codec_for(Compression compression) {
+        switch (compression) {
+            case Compression::Gzip: return CODEC_GZIP;
+            case Compression::Zstd: return CODEC_ZSTD;
+            case Compression::None:
+            default: return CODEC_UNCOMPRESSED;
+        }
+    }
+
+    void put_u32(std::string& out, uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out += static_cast<char>((value >> shift) & 0xFF);
+        }
+    }
+
+    void put_u64(std::string& out, uint64_t value) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            out += static_cast<char>((value >> shift) & 0xFF);
+        }
+    }
+
+    void put_double(std::string& out, double value) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(value));
+        put_u64(out, bits);
+    }
+
+    void put_varint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    size_t repeat_length(const std::vector<uint8_t>& levels, size_t start) {
+        size_t end = start + 1;
+        while (end < levels.size() && levels[end] == levels[start]) ++end;
+        return end - start;
+    }
+
+    // Levels of at most 1 in the RLE/bit-packing hybrid encoding, prefixed by
+    // their length as data page v1 requires. Runs of 8 or more equal levels
+    // become RLE runs; anything else is bit-packed 8 levels to a byte, padded
+    // with zeros only at the end of the page.
+    void put_levels(std::string& out, const std::vector<uint8_t>& levels) {
+        std::string runs;
+        size_t i = 0;
+        while (i < levels.size()) {
+            size_t run = repeat_length(levels, i);
+            if (run >= 8) {
+                put_varint(runs, static_cast<uint64_t>(run) << 1);
+                runs += static_cast<char>(levels[i]);
+                i += run;
+                continue;
+            }
+
+            size_t start = i;
+            size_t groups = 0;
+            do {
+                i += 8;
+                groups++;
+            } while (i < levels.size() && repeat_length(levels, i) < 8);
+
+            put_varint(runs, (static_cast<uint64_t>(groups) << 1) | 1);
+            for (size_t group = 0; group < groups; ++group) {
+                uint8_t packed = 0;
+                for (size_t bit = 0; bit < 8; ++bit) {
+                    size_t index = start + group * 8 + bit;
+                    if (index < levels.size() && levels[index]) packed |= static_cast<uint8_t>(1u << bit);
+                }
+                runs += static_cast<char>(packed);
+            }
+        }
+        put_u32(out, static_cast<uint32_t>(runs.size()));
+        out += runs;
+    }
+
+    // Serialises Thrift structs in the compact protocol, which is how Parquet
+    // encodes page headers and the file footer
+    class ThriftWriter {
+    public:
+        enum Type : uint8_t {
+            BOOL_TRUE = 1, BOOL_FALSE = 2, I32 = 5, I64 = 6, BINARY = 8, LIST = 9, STRUCT = 12
+        };
+
+        explicit ThriftWriter(std::string& out) : m_out(out) { m_last_field.push_back(0); }
+
+        void field_i32(int16_t id, int32_t value) { field_header(id, I32); put_varint(m_out, zigzag(value)); }
+        void field_i64(int16_t id, int64_t value) { field_header(id, I64); put_varint(m_out, zigzag(value)); }
+        void field_bool(int16_t id, bool value) { field_header(id, value ? BOOL_TRUE : BOOL_FALSE); }
+        void field_binary(int16_t id, std::string_view value) {
+            field_header(id, BINARY);
+            put_varint(m_out, value.size());
+            m_out.append(value.data(), value.size());
+        }
+
+        void begin_struct(int16_t id) { field_header(id, STRUCT); m_last_field.push_back(0); }
+        void end_struct() { m_out += '\0'; m_last_field.pop_back(); }
+
+        // Lists: the header, then exactly size elements
+        void begin_list(int16_t id, Type element_type, size_t size) {
+            field_header(id, LIST);
+            if (size < 15) {
+                m_out += static_cast<char>((size << 4) | element_type);
+            } else {
+                m_out += static_cast<char>(0xF0 | element_type);
+                put_varint(m_out, size);
+            }
+        }
+        void element_i32(int32_t value) { put_varint(m_out, zigzag(value)); }
+        void element_binary(std::string_view value) {
+            put_varint(m_out, value.size());
+            m_out.append(value.data(), value.size());
+        }
+        void begin_element_struct() { m_last_field.push_back(0); }
+
+        // Ends the top-level struct
+        void finish() { m_out += '\0'; }
+
+    private:
+        std::string& m_out;
+        std::vector<int16_t> m_last_field;
+
+        static uint64_t zigzag(int64_t value) {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        void field_header(int16_t id, Type type) {
+            int delta = id - m_last_field.back();
+            if (delta > 0 && delta <= 15) {
+                m_out += static_cast<char>((delta << 4) | type);
+            } else {
+                m_out += static_cast<char>(type);
+                put_varint(m_out, zigzag(id));
+            }
+            m_last_field.back() = id;
+        }
+    };
+
+    // LogicalType union members for the schema: STRING, LIST or millisecond TIMESTAMP
+    void put_logical_type(ThriftWriter& thrift, int16_t member) {
+        thrift.begin_struct(10);
+        thrift.begin_struct(member);
+        if (member == 8) {
+            thrift.field_bool(1, true);  // isAdjustedToUTC
+            thrift.begin_struct(2);      // unit
+            thrift.begin_struct(1);      // MILLIS
+            thrift.end_struct();
+            thrift.end_struct();
+        }
+        thrift.end_struct();
+        thrift.end_struct();
+    }
+
+    void put_schema(ThriftWriter& thrift) {
+        size_t element_count = 1;
+        for (const auto& column : COLUMNS) {
+            element_count += column.kind == STRING_LIST ? 3 : 1;
+        }
+
+        thrift.begin_list(2, ThriftWriter::STRUCT, element_count);
+
+        thrift.begin_element_struct();
+        thrift.field_binary(4, "schema");
+        thrift.field_i32(5, static_cast<int32_t>(COLUMN_COUNT));
+        thrift.end_struct();
+
+        for (const auto& column : COLUMNS) {
+            thrift.begin_element_struct();
+            if (column.kind == STRING_LIST) {
+                // Standard three-level list: <name> (LIST) > repeated group list > element
+                thrift.field_i32(3, REQUIRED);
+                thrift.field_binary(4, column.name);
+                thrift.field_i32(5, 1);
+                thrift.field_i32(6, CONVERTED_LIST);
+                put_logical_type(thrift, 3);
+                thrift.end_struct();
+
+                thrift.begin_element_struct();
+                thrift.field_i32(3, REPEATED);
+                thrift.field_binary(4, "list");
+                thrift.field_i32(5, 1);
+                thrift.end_struct();
+
+                thrift.begin_element_struct();
+                thrift.field_i32(1, TYPE_BYTE_ARRAY);
+                thrift.field_i32(3, REQUIRED);
+                thrift.field_binary(4, "element");
+                thrift.field_i32(6, CONVERTED_UTF8);
+                put_logical_type(thrift, 1);
+                thrift.end_struct();
+                continue;
+            }
+
+            bool optional = column.kind == OPTIONAL_DOUBLE || column.kind == OPTIONAL_TIMESTAMP;
+            thrift.field_i32(1, physical_type(column.kind));
+            thrift.field_i32(3, optional ? OPTIONAL : REQUIRED);
+            thrift.field_binary(4, column.name);
+            if (column.kind == STRING) {
+                thrift.field_i32(6, CONVERTED_UTF8);
+                put_logical_type(thrift, 1);
+            } else if (column.kind == OPTIONAL_TIMESTAMP) {
+                thrift.field_i32(6, CONVERTED_TIMESTAMP_MILLIS);
+                put_logical_type(thrift, 8);
+            }
+            thrift.end_struct();
+        }
+    }
+}
+
+ParquetWriter::ParquetWriter()
+    : m_compression(Compression::Gzip)
+    , m_buffered_rows(0)
+    , m_buffered_bytes(0)
+    , m_record_count(0)
+    , m_position(0)
+{}
+
+ParquetWriter::~ParquetWriter() {
+    if (m_file.is_open()) {
+        close();
+    }
+}
+
+bool ParquetWriter::open(const std::string& filename, Compression compression) {
+    if (m_file.is_open()) {
+        close();
+    }
+    m_last_error.clear();
+
+    if (compression != Compression::None && !compression_supported(compression)) {
+        m_last_error = "Compression is not supported by this build";
+        return false;
+    }
+    if (!m_file.open_atomic(filename)) {
+        m_last_error = m_file.last_error();
+        return false;
+    }
+
+    m_compression = compression;
+    m_columns.assign(COLUMN_COUNT, ColumnBuffer());
+    m_row_groups.clear();
+    m_buffered_rows = 0;
+    m_buffered_bytes = 0;
+    m_record_count = 0;
+    m_position = 0;
+    return write_bytes(std::string_view(MAGIC, sizeof(MAGIC)));
+}
+
+void ParquetWriter::append_string(size_t column, std::string_view value) {
+    ColumnBuffer& buffer = m_columns[column];
+    put_u32(buffer.values, static_cast<uint32_t>(value.size()));
+    buffer.values.append(value.data(), value.size());
+    buffer.level_count++;
+    m_buffered_bytes += value.size() + 4;
+}
+
+void ParquetWriter::append_list(size_t column, const std::vector<std::string>& values) {
+    ColumnBuffer& buffer = m_columns[column];
+    if (values.empty()) {
+        // One level entry and no value marks an empty list
+        buffer.repetition.push_back(0);
+        buffer.definition.push_back(0);
+        buffer.level_count++;
+        return;
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        buffer.repetition.push_back(i == 0 ? 0 : 1);
+        buffer.definition.push_back(1);
+        put_u32(buffer.values, static_cast<uint32_t>(values[i].size()));
+        buffer.values += values[i];
+        buffer.level_count++;
+        m_buffered_bytes += values[i].size() + 6;
+    }
+}
+
+bool ParquetWriter::write(const Business& business) {
+    if (!m_file.is_open()) {
+        m_last_error = "Parquet file is not open";
+        return false;
+    }
+
+    append_string(PLACE_ID, business.place_id());
+    append_string(NAME, business.name());
+    append_string(ADDRESS, business.address());
+    append_string(PHONE, business.phone_number());
+    append_string(EMAIL, business.email());
+    append_string(WEBSITE, business.website());
+
+    put_double(m_columns[RATING].values, business.rating());
+    m_columns[RATING].level_count++;
+    put_u32(m_columns[TOTAL_RATINGS].values, static_cast<uint32_t>(business.total_ratings()));
+    m_columns[TOTAL_RATINGS].level_count++;
+
+    auto append_optional_double = [this](size_t column, double value) {
+        ColumnBuffer& buffer = m_columns[column];
+        bool present = !std::isnan(value);
+        buffer.definition.push_back(present ? 1 : 0);
+        if (present) put_double(buffer.values, value);
+        buffer.level_count++;
+    };
+    append_optional_double(LATITUDE, business.latitude());
+    append_optional_double(LONGITUDE, business.longitude());
+
+    ColumnBuffer& fetched_at = m_columns[FETCHED_AT];
+    fetched_at.definition.push_back(business.fetched_at() != 0 ? 1 : 0);
+    if (business.fetched_at() != 0) {
+        put_u64(fetched_at.values, static_cast<uint64_t>(business.fetched_at() * 1000));
+    }
+    fetched_at.level_count++;
+
+    append_list(NUMBERS, business.additional_numbers());
+    append_list(EMAILS, business.additional_emails());
+    append_list(SOCIAL, business.social_media_links());
+
+    m_buffered_bytes += 40;
+    m_buffered_rows++;
+    m_record_count++;
+
+    if (m_buffered_rows >= ROW_GROUP_ROWS || m_buffered_bytes >= ROW_GROUP_BYTES) {
+        return flush_row_group();
+    }
+    return true;
+}
+
+bool ParquetWriter::write_bytes(std::string_view bytes) {
+    m_file.write(bytes);
+    m_position += bytes.size();
+    if (!m_file.ok()) {
+        m_last_error = m_file.last_error();
+        return false;
+    }
+    return true;
+}
+
+// Writes every column's buffer as one data page (v1): repetition levels,
+// definition levels and values, compressed together
+bool ParquetWriter::flush_row_group() {
+    if (m_buffered_rows == 0) {
+        return true;
+    }
+
+    RowGroupInfo row_group;
+    row_group.row_count = static_cast<int64_t>(m_buffered_rows);
+    row_group.uncompressed_size = 0;
+    row_group.compressed_size = 0;
+
+    std::string page;
+    std::string compressed;
+    std::string header;
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        ColumnBuffer& buffer = m_columns[i];
+
+        page.clear();
+        if (COLUMNS[i].kind == STRING_LIST) put_levels(page, buffer.repetition);
+        if (has_definition_levels(COLUMNS[i].kind)) put_levels(page, buffer.definition);
+        page += buffer.values;
+
+        const std::string* body = &page;
+        if (m_compression != Compression::None) {
+            compressed.clear();
+            StringSink target(compressed);
+            CompressedSink codec(target, m_compression);
+            codec.write(page);
+            if (!codec.finish() || !target.flush()) {
+                m_last_error = codec.last_error();
+                return false;
+            }
+            body = &compressed;
+        }
+
+        header.clear();
+        ThriftWriter thrift(header);
+        thrift.field_i32(1, PAGE_DATA);
+        thrift.field_i32(2, static_cast<int32_t>(page.size()));
+        thrift.field_i32(3, static_cast<int32_t>(body->size()));
+        thrift.begin_struct(5);
+        thrift.field_i32(1, static_cast<int32_t>(buffer.level_count));
+        thrift.field_i32(2, ENCODING_PLAIN);
+        thrift.field_i32(3, ENCODING_RLE);
+        thrift.field_i32(4, ENCODING_RLE);
+        thrift.end_struct();
+        thrift.finish();
+
+        ChunkInfo chunk;
+        chunk.offset = static_cast<int64_t>(m_position);
+        chunk.level_count = static_cast<int64_t>(buffer.level_count);
+        chunk.uncompressed_size = static_cast<int64_t>(header.size() + page.size());
+        chunk.compressed_size = static_cast<int64_t>(header.size() + body->size());
+        if (!write_bytes(header) || !write_bytes(*body)) {
+            return false;
+        }
+
+        row_group.chunks.push_back(chunk);
+        row_group.uncompressed_size += chunk.uncompressed_size;
+        row_group.compressed_size += chunk.compressed_size;
+        buffer = ColumnBuffer();
+    }
+
+    m_row_groups.push_back(std::move(row_group));
+    m_buffered_rows = 0;
+    m_buffered_bytes = 0;
+    return true;
+}
+
+bool ParquetWriter::write_footer() {
+    std::string footer;
+    ThriftWriter thrift(footer);
+
+    thrift.field_i32(1, 1);  // version
+    put_schema(thrift);
+    thrift.field_i64(3, static_cast<int64_t>(m_record_count));
+
+    thrift.begin_list(4, ThriftWriter::STRUCT, m_row_groups.size());
+    for (const auto& row_group : m_row_groups) {
+        thrift.begin_element_struct();
+        thrift.begin_list(1, ThriftWriter::STRUCT, row_group.chunks.size());
+        for (size_t i = 0; i < row_group.chunks.size(); ++i) {
+            const ChunkInfo& chunk = row_group.chunks[i];
+            ColumnKind kind = COLUMNS[i].kind;
+
+            thrift.begin_element_struct();
+            thrift.field_i64(2, chunk.offset);
+            thrift.begin_struct(3);
+            thrift.field_i32(1, physical_type(kind));
+            thrift.begin_list(2, ThriftWriter::I32, 2);
+            thrift.element_i32(ENCODING_PLAIN);
+            thrift.element_i32(ENCODING_RLE);
+            if (kind == STRING_LIST) {
+                thrift.begin_list(3, ThriftWriter::BINARY, 3);
+                thrift.element_binary(COLUMNS[i].name);
+                thrift.element_binary("list");
+                thrift.element_binary("element");
+            } else {
+                thrift.begin_list(3, ThriftWriter::BINARY, 1);
+                thrift.element_binary(COLUMNS[i].name);
+            }
+            thrift.field_i32(4, codec_for(m_compression));
+            thrift.field_i64(5, chunk.level_count);
+            thrift.field_i64(6, chunk.uncompressed_size);
+            thrift.field_i64(7, chunk.compressed_size);
+            thrift.field_i64(9, chunk.offset);
+            thrift.end_struct();
+            thrift.end_struct();
+        }
+        thrift.field_i64(2, row_group.uncompressed_size);
+        thrift.field_i64(3, row_group.row_count);
+        thrift.field_i64(6, row_group.compressed_size);
+        thrift.end_struct();
+    }
+
+    thrift.field_binary(6, CREATED_BY);
+    thrift.finish();
+
+    std::string length;
+    put_u32(length, static_cast<uint32_t>(footer.size()));
+    return write_bytes(footer) && write_bytes(length) && write_bytes(std::string_view(MAGIC, sizeof(MAGIC)));
+}
+
+bool ParquetWriter::close() {
+    if (!m_file.is_open()) {
+        return m_last_error.empty();
+    }
+
+    // Only a file with its footer replaces FILENAME; otherwise the .partial file stays
+    bool written = flush_row_group() && write_footer();
+    if (!written) {
+        m_file.close();
+    } else if (!m_file.commit()) {
+        m_last_error = m_file.last_error();
+        written = false;
+    }
+    m_columns.clear();
+    m_row_groups.clear();
+    return written;
+}
@@ -1,20 +1,27 @@
 #include "scrapers/MapScraper.h"
+#include "core/Metrics.h"
+#include "core/ScratchArena.h"
+#include "core/Trace.h"
 #include <iostream>
 #include <curl/curl.h>
 #include <json/json.h>
 #include <sstream>
 #include <thread>
 #include <chrono>
+#include <ctime>
+#include <mutex>
 
 MapScraper::MapScraper()
     : m_max_radius(5000)
     , m_max_results(20)
+    , m_metrics(nullptr)
 {}
 
 MapScraper::MapScraper(const std::string& api_key)
     : m_api_key(api_key)
     , m_max_radius(5000)
     , m_max_results(20)
+    , m_metrics(nullptr)
 {}
 
 MapScraper::MapScraper(const std::string& api_key, const std::string& keyword, const std::string& location,
@@ -24,29 +31,32 @@ MapScraper::MapScraper(const std::string& api_key, const std::string& keyword, c
     , m_location(location)
     , m_max_radius(max_radius)
     , m_max_results(max_results)
+    , m_metrics(nullptr)
 {}
 
 MapScraper::~MapScraper() {}
 
 namespace {
-    // URL encoding function
-    std::string url_encode(const std::string& value) {
-        CURL* curl = curl_easy_init();
-        if (curl) {
-            char* encoded = curl_easy_escape(curl, value.c_str(), value.length());
-            if (encoded) {
-                std::string result(encoded);
-                curl_free(encoded);
-                curl_easy_cleanup(curl);
-                return result;
+    // Percent-encode everything but RFC 3986 unreserved characters, appending to out.
+    // The ASCII test is spelled out: isalnum() follows the locale, which the GUI sets
+    // from the environment, and would pass Latin-1 letters through unencoded.
+    void url_encode(std::string_view value, std::pmr::string& out) {
+        static const char hex[] = "0123456789ABCDEF";
+        for (char c : value) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            bool alnum = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+            if (alnum || c == '-' || c == '_' || c == '.' || c == '~') {
+                out += c;
+            } else {
+                out += '%';
+                out += hex[byte >> 4];
+                out += hex[byte & 0x0F];
             }
-            curl_easy_cleanup(curl);
         }
-        return value; // fallback to original if encoding fails
     }
 
     // Callback function for curl to write response data
-    size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
+    size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::pmr::string* s) {
         size_t newLength = size * nmemb;
         try {
             s->append((char*)contents, newLength);
@@ -55,60 +65,143 @@ namespace {
         }
         return newLength;
     }
+
+    // One curl handle per thread so keep-alive connections are reused across requests
+    struct ThreadCurlHandle {
+        CURL* handle = curl_easy_init();
+        ~ThreadCurlHandle() {
+            if (handle) {
+                curl_easy_cleanup(handle);
+            }
+        }
+    };
+
+    // Host part of a URL, used to label per-host metrics
+    std::string host_from_url(std::string_view url) {
+        size_t start = url.find("://");
+        start = (start == std::string_view::npos) ? 0 : start + 3;
+        size_t end = url.find_first_of(":/?#", start);
+        return std::string(url.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+    }
+
+    // Short error type for metrics labels
+    std::string curl_error_type(CURLcode code) {
+        switch (code) {
+            case CURLE_OPERATION_TIMEDOUT: return "timeout";
+            case CURLE_COULDNT_RESOLVE_HOST: return "dns";
+            case CURLE_COULDNT_CONNECT: return "connect";
+            case CURLE_SSL_CONNECT_ERROR: return "tls";
+            case CURLE_TOO_MANY_REDIRECTS: return "redirects";
+            default: return "curl_" + std::to_string(static_cast<int>(code));
+        }
+    }
+
+    CURL* thread_curl_handle() {
+        thread_local ThreadCurlHandle curl_handle;
+        if (curl_handle.handle) {
+            curl_easy_reset(curl_handle.handle);
+        }
+        return curl_handle.handle;
+    }
+
+    // Parses straight from the response buffer; the reader is reused per thread
+    bool parse_json(std::string_view text, Json::Value& root) {
+        thread_local std::unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder().newCharReader());
+        return reader->parse(text.data(), text.data() + text.size(), &root, nullptr);
+    }
 } // end anonymous namespace
 
-std::string MapScraper::build_search_url() const {
-    std::string base_url = "https://maps.googleapis.com/maps/api/place/textsearch/json?";
+void MapScraper::initialize_http() {
+    static std::once_flag init_flag;
+    std::call_once(init_flag, []() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+    });
+}
+
+std::pmr::string MapScraper::build_search_url(std::pmr::memory_resource* scratch) const {
+    std::pmr::string url(scratch);
+    url.reserve(128 + 3 * (m_keyword.size() + m_location.size()) + m_api_key.size());
+    url += "https://maps.googleapis.com/maps/api/place/textsearch/json?";
 
     // Build the query string properly encoded
-    std::string search_query = m_keyword + " in " + m_location;
-    std::string encoded_query = url_encode(search_query);
+    url += "query=";
+    url_encode(m_keyword, url);
+    url_encode(" in ", url);
+    url_encode(m_location, url);
 
-    std::string query = "query=" + encoded_query;
-    std::string key = "&key=" + m_api_key;
+    url += "&key=";
+    url += m_api_key;
 
-    return base_url + query + key;
-}std::string MapScraper::make_http_request(const std::string& url) const {
+    return url;
+}
+
+std::pmr::string MapScraper::make_http_request(const std::pmr::string& url, std::pmr::memory_resource* scratch) const {
+    TRACE_SCOPE("make_http_request");
     CURL* curl;
     CURLcode res;
-    std::string response_string;
+    std::pmr::string response_string(scratch);
 
-    curl = curl_easy_init();
+    curl = thread_curl_handle();
     if (curl) {
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_string);
         curl_easy_setopt(curl, CURLOPT_USERAGENT, "business-scraper/1.0");
 
-        res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+        {
+            ScopedLatency latency(m_metrics, "http_request", m_metrics ? host_from_url(url) : "");
+            res = curl_easy_perform(curl);
+        }
+
+        if (m_metrics) {
+            m_metrics->increment("requests", "maps");
+            m_metrics->increment("bytes_received", "maps", response_string.size());
+            long status = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+            if (res != CURLE_OK) {
+                m_metrics->increment("errors", curl_error_type(res));
+            } else if (status >= 400) {
+                m_metrics->increment("errors", "http_" + std::to_string(status));
+            }
+        }
 
         if (res != CURLE_OK) {
             std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
-            return "";
+            response_string.clear();
         }
     }
 
     return response_string;
 }
 
-Business MapScraper::parse_business_details(const std::string& place_id) const {
-    std::string details_url = "https://maps.googleapis.com/maps/api/place/details/json?";
-    details_url += "place_id=" + place_id;
-    details_url += "&fields=name,formatted_address,formatted_phone_number,website,rating,user_ratings_total";
-    details_url += "&key=" + m_api_key;
+Business MapScraper::parse_business_details(const std::string& place_id, std::pmr::memory_resource* scratch) const {
+    TRACE_SCOPE("parse_business_details");
+    ScopedLatency latency(m_metrics, "place_details");
+
+    std::pmr::string details_url(scratch);
+    details_url += "https://maps.googleapis.com/maps/api/place/details/json?";
+    details_url += "place_id=";
+    details_url += place_id;
+    details_url += "&fields=name,formatted_address,formatted_phone_number,website,rating,user_ratings_total,geometry";
+    details_url += "&key=";
+    details_url += m_api_key;
 
-    std::string response = make_http_request(details_url);
+    std::pmr::string response = make_http_request(details_url, scratch);
     Business business;
+    business.set_place_id(place_id);
+    business.set_fetched_at(static_cast<int64_t>(std::time(nullptr)));
 
     if (response.empty()) {
         return business;
     }
 
     Json::Value root;
-    Json::Reader reader;
 
-    if (reader.parse(response, root)) {
+    if (!parse_json(response, root)) {
+        if (m_metrics) {
+            m_metrics->increment("errors", "json_parse");
+        }
+    } else {
         const Json::Value& result = root["result"];
 
         if (!result.isNull()) {
@@ -130,18 +223,21 @@ Business MapScraper::parse_business_details(const std::string& place_id) const {
             if (!result["user_ratings_total"].isNull()) {
                 business.set_total_ratings(result["user_ratings_total"].asInt());
             }
+            const Json::Value& location = result["geometry"]["location"];
+            if (location["lat"].isNumeric() && location["lng"].isNumeric()) {
+                business.set_coordinates(location["lat"].asDouble(), location["lng"].asDouble());
+            }
         }
     }
 
     return business;
 }
 
-std::vector<Business> MapScraper::parse_response(const std::string& json_response) const {
+std::vector<Business> MapScraper::parse_response(std::string_view json_response, std::pmr::memory_resource* scratch) const {
     std::vector<Business> businesses;
     Json::Value root;
-    Json::Reader reader;
 
-    if (!reader.parse(json_response, root)) {
+    if (!parse_json(json_response, root)) {
         std::cerr << "Failed to parse JSON response" << std::endl;
         return businesses;
     }
@@ -158,10 +254,19 @@ std::vector<Business> MapScraper::parse_response(const std::string& json_respons
 
         std::string place_id = result["place_id"].asString();
         if (!place_id.empty()) {
-            Business business = parse_business_details(place_id);
+            if (m_place_known && m_place_known(place_id)) {
+                count++;
+                continue;
+            }
+            if (m_place_filter && !m_place_filter(place_id)) {
+                continue;
+            }
+            Business business = parse_business_details(place_id, scratch);
             if (!business.name().empty()) {
-                businesses.push_back(business);
+                businesses.push_back(std::move(business));
                 count++;
+            } else if (m_place_filter && m_place_release) {
+                m_place_release(place_id);
             }
         }
     }
@@ -169,13 +274,16 @@ std::vector<Business> MapScraper::parse_response(const std::string& json_respons
     return businesses;
 }
 
-std::vector<Business> MapScraper::parse_response_with_pagination(const std::string& json_response, std::string& next_page_token, int& current_count) const {
+std::vector<Business> MapScraper::parse_response_with_pagination(std::string_view json_response, std::string& next_page_token, int& current_count,
+                                                                 std::pmr::memory_resource* scratch) const {
     std::vector<Business> businesses;
     Json::Value root;
-    Json::Reader reader;
 
-    if (!reader.parse(json_response, root)) {
+    if (!parse_json(json_response, root)) {
         std::cerr << "Failed to parse JSON response" << std::endl;
+        if (m_metrics) {
+            m_metrics->increment("errors", "json_parse");
+        }
         return businesses;
     }
 
@@ -193,13 +301,25 @@ std::vector<Business> MapScraper::parse_response_with_pagination(const std::stri
     }
 
     for (const auto& result : results) {
-        if (current_count >= m_max_results) break;
+        if (current_count + static_cast<int>(businesses.size()) >= m_max_results) break;
 
         std::string place_id = result["place_id"].asString();
         if (!place_id.empty()) {
-            Business business = parse_business_details(place_id);
+            if (m_place_known && m_place_known(place_id)) {
+                current_count++;
+                continue;
+            }
+            if (m_place_filter && !m_place_filter(place_id)) {
+                continue;
+            }
+            Business business = parse_business_details(place_id, scratch);
             if (!business.name().empty()) {
-                businesses.push_back(business);
+                if (m_business_callback) {
+                    m_business_callback(business);
+                }
+                businesses.push_back(std::move(business));
+            } else if (m_place_filter && m_place_release) {
+                m_place_release(place_id);
             }
         }
     }
@@ -216,11 +336,13 @@ std::vector<Business> MapScraper::search_businesses() {
     std::vector<Business> all_businesses;
     std::string next_page_token;
     int total_fetched = 0;
+    ScratchArena scratch;
 
     do {
-        std::string url = build_search_url();
+        std::pmr::string url = build_search_url(scratch.resource());
         if (!next_page_token.empty()) {
-            url += "&pagetoken=" + next_page_token;
+            url += "&pagetoken=";
+            url += next_page_token;
 
             // Google API requires a delay between page requests
             std::cout << "Waiting for next page..." << std::endl;
@@ -229,24 +351,42 @@ std::vector<Business> MapScraper::search_businesses() {
 
         std::cout << "Making request to: " << url << std::endl;
 
-        std::string response = make_http_request(url);
+        std::pmr::string response(scratch.resource());
+        {
+            ScopedLatency latency(m_metrics, "search_page");
+            response = make_http_request(url, scratch.resource());
+        }
         if (response.empty()) {
             std::cerr << "Failed to get response from Google Maps API" << std::endl;
             break;
         }
 
         // Parse this page and get next_page_token
-        auto page_result = parse_response_with_pagination(response, next_page_token, total_fetched);
+        auto page_result = parse_response_with_pagination(response, next_page_token, total_fetched, scratch.resource());
 
         // Add businesses from this page
-        for (const auto& business : page_result) {
+        for (auto& business : page_result) {
             if (total_fetched >= m_max_results) break;
-            all_businesses.push_back(business);
+            all_businesses.push_back(std::move(business));
             total_fetched++;
         }
 
+        // The page's scratch strings are no longer read; their destructors are
+        // no-ops on a monotonic resource, so the arena can be reset here
+        scratch.release();
+
         // Stop if we have enough results or no more pages
     } while (!next_page_token.empty() && total_fetched < m_max_results);
 
     return all_businesses;
-}
\ No newline at end of file
+}
+
+Business MapScraper::fetch_business(const std::string& place_id) const {
+    if (m_api_key.empty() || place_id.empty()) {
+        std::cerr << "API key and place ID must be set before fetching details" << std::endl;
+        return Business();
+    }
+
+    ScratchArena scratch;
+    return parse_business_details(place_id, scratch.resource());
+}
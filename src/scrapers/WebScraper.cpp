@@ -1,13 +1,16 @@
 #include "scrapers/WebScraper.h"
+#include "core/Metrics.h"
+#include "core/Trace.h"
 #include <iostream>
 #include <curl/curl.h>
 #include <algorithm>
+#include <cctype>
 #include <set>
 #include <sstream>
 
 namespace {
     // Callback function for curl to write response data
-    size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
+    size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::pmr::string* s) {
         size_t newLength = size * nmemb;
         try {
             s->append((char*)contents, newLength);
@@ -17,65 +20,106 @@ namespace {
         return newLength;
     }
 
+    // Host part of a URL, used to label per-host metrics
+    std::string host_from_url(std::string_view url) {
+        size_t start = url.find("://");
+        start = (start == std::string_view::npos) ? 0 : start + 3;
+        size_t end = url.find_first_of(":/?#", start);
+        return std::string(url.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+    }
+
+    // Short error type for metrics labels
+    std::string curl_error_type(CURLcode code) {
+        switch (code) {
+            case CURLE_OPERATION_TIMEDOUT: return "timeout";
+            case CURLE_COULDNT_RESOLVE_HOST: return "dns";
+            case CURLE_COULDNT_CONNECT: return "connect";
+            case CURLE_SSL_CONNECT_ERROR: return "tls";
+            case CURLE_TOO_MANY_REDIRECTS: return "redirects";
+            default: return "curl_" + std::to_string(static_cast<int>(code));
+        }
+    }
+
     // Helper functions for URL and data validation/formatting
-    std::string clean_url(const std::string& url) {
-        std::string cleaned = url;
+    std::pmr::string clean_url(const std::string& url, std::pmr::memory_resource* scratch) {
+        std::pmr::string cleaned(scratch);
 
         // Add protocol if missing
-        if (cleaned.find("http://") != 0 && cleaned.find("https://") != 0) {
-            cleaned = "https://" + cleaned;
+        if (url.find("http://") != 0 && url.find("https://") != 0) {
+            cleaned = "https://";
         }
+        cleaned += url;
 
         return cleaned;
     }
 
-    bool is_valid_email(const std::string& email) {
+    bool is_valid_email(std::string_view email) {
         // Basic validation - regex already does most of the work
         return !email.empty() &&
-               email.find("@") != std::string::npos &&
-               email.find(".") != std::string::npos &&
+               email.find("@") != std::string_view::npos &&
+               email.find(".") != std::string_view::npos &&
                email.length() > 5 &&
-               email.find("..") == std::string::npos && // No consecutive dots
-               email.find("@.") == std::string::npos && // No @ followed by dot
-               email.find(".@") == std::string::npos;   // No dot followed by @
+               email.find("..") == std::string_view::npos && // No consecutive dots
+               email.find("@.") == std::string_view::npos && // No @ followed by dot
+               email.find(".@") == std::string_view::npos;   // No dot followed by @
     }
 
-    bool is_valid_phone(const std::string& phone) {
+    bool is_valid_phone(std::string_view phone) {
         // Check if normalized phone has reasonable length
-        std::string digits_only;
-        for (char c : phone) {
-            if (std::isdigit(c)) {
-                digits_only += c;
-            }
-        }
+        size_t digit_count = std::count_if(phone.begin(), phone.end(),
+                                           [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
 
-        return digits_only.length() >= 10 && digits_only.length() <= 15;
+        return digit_count >= 10 && digit_count <= 15;
     }
 
-    std::string normalize_phone(const std::string& phone) {
+    std::pmr::string normalize_phone(std::string_view phone, std::pmr::memory_resource* scratch) {
         // Extract only digits
-        std::string digits;
+        std::pmr::string digits(scratch);
+        digits.reserve(phone.size());
         for (char c : phone) {
-            if (std::isdigit(c)) {
+            if (std::isdigit(static_cast<unsigned char>(c))) {
                 digits += c;
             }
         }
 
         // Format as (XXX) XXX-XXXX for US numbers
-        if (digits.length() == 10) {
-            return "(" + digits.substr(0, 3) + ") " + digits.substr(3, 3) + "-" + digits.substr(6, 4);
-        } else if (digits.length() == 11 && digits[0] == '1') {
-            return "+1 (" + digits.substr(1, 3) + ") " + digits.substr(4, 3) + "-" + digits.substr(7, 4);
+        std::string_view d(digits);
+        std::pmr::string formatted(scratch);
+        if (d.length() == 10) {
+            formatted.reserve(14);
+            formatted.append("(").append(d.substr(0, 3)).append(") ").append(d.substr(3, 3)).append("-").append(d.substr(6, 4));
+        } else if (d.length() == 11 && d[0] == '1') {
+            formatted.reserve(17);
+            formatted.append("+1 (").append(d.substr(1, 3)).append(") ").append(d.substr(4, 3)).append("-").append(d.substr(7, 4));
+        } else {
+            // Return original if can't normalize
+            formatted.assign(phone);
         }
+        return formatted;
+    }
 
-        // Return original if can't normalize
-        return phone;
+    // Calls on_match with each non-overlapping match of pattern in content.
+    // Match state is allocated from scratch rather than the global heap.
+    template <typename Callback>
+    void for_each_match(std::string_view content, const std::regex& pattern, std::pmr::memory_resource* scratch, Callback on_match) {
+        std::pmr::cmatch match(scratch);
+        const char* begin = content.data();
+        const char* end = content.data() + content.size();
+        auto flags = std::regex_constants::match_default;
+
+        while (begin != end && std::regex_search(begin, end, match, pattern, flags)) {
+            on_match(std::string_view(match[0].first, static_cast<size_t>(match[0].length())));
+            begin = match[0].length() > 0 ? match[0].second : match[0].second + 1;
+            flags |= std::regex_constants::match_prev_avail;
+        }
     }
 }
 
 WebScraper::WebScraper()
     : m_timeout(10)
     , m_max_retries(3)
+    , m_metrics(nullptr)
+    , m_scratch(256 * 1024)
     , m_email_regex(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})")
     , m_phone_regex(R"(\+?1?[-.\s]?\(?([0-9]{3})\)?[-.\s]?([0-9]{3})[-.\s]?([0-9]{4}))")
     , m_social_regex(R"(https?://(www\.)?(facebook|twitter|instagram|linkedin|youtube|tiktok)\.com/[^\s<>"']+)")
@@ -88,13 +132,7 @@ void WebScraper::enhance_businesses(std::vector<Business>& businesses) {
 
     int processed = 0;
     for (auto& business : businesses) {
-        if (!business.website().empty()) {
-            std::cout << "Processing: " << business.name() << "..." << std::endl;
-
-            std::string content = fetch_website_content(business.website());
-            if (!content.empty()) {
-                extract_contact_info(business, content);
-            }
+        if (enhance_business(business)) {
             processed++;
         }
     }
@@ -102,12 +140,31 @@ void WebScraper::enhance_businesses(std::vector<Business>& businesses) {
     std::cout << "Enhanced " << processed << " businesses with website data." << std::endl;
 }
 
-std::string WebScraper::fetch_website_content(const std::string& url) const {
+bool WebScraper::enhance_business(Business& business) {
+    if (business.website().empty()) {
+        return false;
+    }
+
+    std::cout << "Processing: " << business.name() << "..." << std::endl;
+
+    {
+        std::pmr::string content = fetch_website_content(business.website(), m_scratch.resource());
+        if (!content.empty()) {
+            ScopedLatency latency(m_metrics, "contact_extraction");
+            extract_contact_info(business, content, m_scratch.resource());
+        }
+    }
+    m_scratch.release();
+    return true;
+}
+
+std::pmr::string WebScraper::fetch_website_content(const std::string& url, std::pmr::memory_resource* scratch) const {
+    TRACE_SCOPE("fetch_website_content");
     CURL* curl;
     CURLcode res;
-    std::string response_string;
+    std::pmr::string response_string(scratch);
 
-    std::string clean_url_str = clean_url(url);
+    std::pmr::string clean_url_str = clean_url(url, scratch);
 
     curl = curl_easy_init();
     if (curl) {
@@ -121,120 +178,122 @@ std::string WebScraper::fetch_website_content(const std::string& url) const {
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
 
-        res = curl_easy_perform(curl);
+        {
+            ScopedLatency latency(m_metrics, "website_fetch", m_metrics ? host_from_url(clean_url_str) : "");
+            res = curl_easy_perform(curl);
+        }
+
+        if (m_metrics) {
+            m_metrics->increment("requests", "website");
+            m_metrics->increment("bytes_received", "website", response_string.size());
+            long status = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+            if (res != CURLE_OK) {
+                m_metrics->increment("errors", curl_error_type(res));
+            } else if (status >= 400) {
+                m_metrics->increment("errors", "http_" + std::to_string(status));
+            }
+        }
         curl_easy_cleanup(curl);
 
         if (res != CURLE_OK) {
             std::cerr << "Failed to fetch " << clean_url_str << ": " << curl_easy_strerror(res) << std::endl;
-            return "";
+            response_string.clear();
         }
     }
 
     return response_string;
 }
 
-void WebScraper::extract_contact_info(Business& business, const std::string& html_content) const {
+void WebScraper::extract_contact_info(Business& business, std::string_view html_content, std::pmr::memory_resource* scratch) const {
+    TRACE_SCOPE("extract_contact_info");
+    // Only values that are kept get copied out of scratch memory
     // Extract emails
-    std::vector<std::string> emails = extract_emails(html_content);
-    for (const auto& email : emails) {
+    auto emails = extract_emails(html_content, scratch);
+    for (std::string_view email : emails) {
         if (business.email().empty()) {
-            business.set_email(email);
+            business.set_email(std::string(email));
         } else {
             // Add to additional emails if it's different from primary
             if (email != business.email()) {
-                auto additional = business.additional_emails();
+                const auto& additional = business.additional_emails();
                 if (std::find(additional.begin(), additional.end(), email) == additional.end()) {
-                    additional.push_back(email);
-                    business.set_additional_emails(additional);
+                    business.add_additional_email(std::string(email));
                 }
             }
         }
     }
 
     // Extract phone numbers
-    std::vector<std::string> phones = extract_phone_numbers(html_content);
+    auto phones = extract_phone_numbers(html_content, scratch);
     for (const auto& phone : phones) {
-        std::string normalized = normalize_phone(phone);
+        std::pmr::string normalized_phone = normalize_phone(phone, scratch);
+        std::string_view normalized(normalized_phone);
         if (business.phone_number().empty()) {
-            business.set_phone_number(normalized);
+            business.set_phone_number(std::string(normalized));
         } else {
             // Add to additional phones if it's different from primary
             if (normalized != business.phone_number()) {
-                auto additional = business.additional_numbers();
+                const auto& additional = business.additional_numbers();
                 if (std::find(additional.begin(), additional.end(), normalized) == additional.end()) {
-                    additional.push_back(normalized);
-                    business.set_additional_numbers(additional);
+                    business.add_additional_number(std::string(normalized));
                 }
             }
         }
     }
 
     // Extract social media links
-    std::vector<std::string> social_links = extract_social_links(html_content);
-    auto current_social = business.social_media_links();
-    for (const auto& link : social_links) {
+    auto social_links = extract_social_links(html_content, scratch);
+    for (std::string_view link : social_links) {
+        const auto& current_social = business.social_media_links();
         if (std::find(current_social.begin(), current_social.end(), link) == current_social.end()) {
-            current_social.push_back(link);
+            business.add_social_link(std::string(link));
         }
     }
-    business.set_social_media_links(current_social);
 }
 
-std::vector<std::string> WebScraper::extract_emails(const std::string& content) const {
-    std::vector<std::string> emails;
-    std::set<std::string> unique_emails; // Prevent duplicates
-
-    std::sregex_iterator start(content.begin(), content.end(), m_email_regex);
-    std::sregex_iterator end;
+std::pmr::vector<std::pmr::string> WebScraper::extract_emails(std::string_view content, std::pmr::memory_resource* scratch) const {
+    std::pmr::vector<std::pmr::string> emails(scratch);
+    std::pmr::set<std::pmr::string> unique_emails(scratch); // Prevent duplicates
 
-    for (std::sregex_iterator i = start; i != end; ++i) {
-        std::string email = (*i).str();
+    for_each_match(content, m_email_regex, scratch, [&](std::string_view match) {
+        std::pmr::string email(match, scratch);
         std::transform(email.begin(), email.end(), email.begin(), ::tolower);
 
-        if (is_valid_email(email) && unique_emails.find(email) == unique_emails.end()) {
-            unique_emails.insert(email);
-            emails.push_back(email);
+        if (is_valid_email(email) && unique_emails.insert(email).second) {
+            emails.push_back(std::move(email));
         }
-    }
+    });
 
     return emails;
 }
 
-std::vector<std::string> WebScraper::extract_phone_numbers(const std::string& content) const {
-    std::vector<std::string> phones;
-    std::set<std::string> unique_phones; // Prevent duplicates
-
-    std::sregex_iterator start(content.begin(), content.end(), m_phone_regex);
-    std::sregex_iterator end;
+std::pmr::vector<std::pmr::string> WebScraper::extract_phone_numbers(std::string_view content, std::pmr::memory_resource* scratch) const {
+    std::pmr::vector<std::pmr::string> phones(scratch);
+    std::pmr::set<std::pmr::string> unique_phones(scratch); // Prevent duplicates
 
-    for (std::sregex_iterator i = start; i != end; ++i) {
-        std::string phone = (*i).str();
-        std::string normalized = normalize_phone(phone);
+    for_each_match(content, m_phone_regex, scratch, [&](std::string_view match) {
+        std::pmr::string normalized = normalize_phone(match, scratch);
 
-        if (is_valid_phone(normalized) && unique_phones.find(normalized) == unique_phones.end()) {
-            unique_phones.insert(normalized);
-            phones.push_back(normalized);
+        if (is_valid_phone(normalized) && unique_phones.insert(normalized).second) {
+            phones.push_back(std::move(normalized));
         }
-    }
+    });
 
     return phones;
 }
 
-std::vector<std::string> WebScraper::extract_social_links(const std::string& content) const {
-    std::vector<std::string> social_links;
-    std::set<std::string> unique_links; // Prevent duplicates
-
-    std::sregex_iterator start(content.begin(), content.end(), m_social_regex);
-    std::sregex_iterator end;
+std::pmr::vector<std::pmr::string> WebScraper::extract_social_links(std::string_view content, std::pmr::memory_resource* scratch) const {
+    std::pmr::vector<std::pmr::string> social_links(scratch);
+    std::pmr::set<std::pmr::string> unique_links(scratch); // Prevent duplicates
 
-    for (std::sregex_iterator i = start; i != end; ++i) {
-        std::string link = (*i).str();
+    for_each_match(content, m_social_regex, scratch, [&](std::string_view match) {
+        std::pmr::string link(match, scratch);
 
-        if (unique_links.find(link) == unique_links.end()) {
-            unique_links.insert(link);
-            social_links.push_back(link);
+        if (unique_links.insert(link).second) {
+            social_links.push_back(std::move(link));
         }
-    }
+    });
 
     return social_links;
 }
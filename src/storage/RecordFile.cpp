@@ -0,0 +1,646 @@
+#include "storage/RecordFile.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char MAGIC[4] = {'B', 'S', 'R', 'F'};
+    const size_t HEADER_SIZE = 12;
+    const size_t TRAILER_SIZE_V1 = 20;
+    const size_t TRAILER_SIZE = 36;
+
+    enum FieldType : uint8_t {
+        TYPE_STRING = 0,
+        TYPE_DOUBLE = 1,
+        TYPE_INT32 = 2,
+        TYPE_STRING_LIST = 3,
+        TYPE_STRING_REF = 4,
+        TYPE_STRING_REF_LIST = 5
+    };
+
+    // Inline and table-backed strings fill the same RecordView slots
+    FieldType slot_kind(uint8_t type) {
+        if (type == TYPE_STRING_REF) return TYPE_STRING;
+        if (type == TYPE_STRING_REF_LIST) return TYPE_STRING_LIST;
+        return static_cast<FieldType>(type);
+    }
+
+    struct FieldDefinition {
+        const char* name;
+        FieldType type;
+        int slot;
+    };
+
+    // Schema written by this version; slots index RecordView's string, double and list arrays
+    const FieldDefinition FIELDS[] = {
+        {"place_id", TYPE_STRING, 0},
+        {"name", TYPE_STRING_REF, 1},
+        {"address", TYPE_STRING, 2},
+        {"phone_number", TYPE_STRING, 3},
+        {"email", TYPE_STRING_REF, 4},
+        {"website", TYPE_STRING_REF, 5},
+        {"rating", TYPE_DOUBLE, 0},
+        {"total_ratings", TYPE_INT32, 0},
+        {"latitude", TYPE_DOUBLE, 1},
+        {"longitude", TYPE_DOUBLE, 2},
+        {"fetched_at", TYPE_DOUBLE, 3},  // Unix seconds; a double so older readers can skip it
+        {"additional_numbers", TYPE_STRING_LIST, 0},
+        {"additional_emails", TYPE_STRING_REF_LIST, 1},
+        {"social_media_links", TYPE_STRING_REF_LIST, 2},
+    };
+
+    void put_u16(std::string& out, uint16_t value) {
+        out += static_cast<char>(value & 0xFF);
+        out += static_cast<char>(value >> 8);
+    }
+
+    void put_u32(std::string& out, uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out += static_cast<char>((value >> shift) & 0xFF);
+        }
+    }
+
+    void put_u64(std::string& out, uint64_t value) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            out += static_cast<char>((value >> shift) & 0xFF);
+        }
+    }
+
+    void put_double(std::string& out, double value) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(value));
+        put_u64(out, bits);
+    }
+
+    void put_string(std::string& out, const std::string& value) {
+        put_u32(out, static_cast<uint32_t>(value.size()));
+        out += value;
+    }
+
+    void put_strings(std::string& out, const std::vector<std::string>& values) {
+        put_u32(out, static_cast<uint32_t>(values.size()));
+        for (const auto& value : values) {
+            put_string(out, value);
+        }
+    }
+
+    uint16_t get_u16(const char* data) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    uint32_t get_u32(const char* data) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    uint64_t get_u64(const char* data) {
+        return static_cast<uint64_t>(get_u32(data)) | (static_cast<uint64_t>(get_u32(data + 4)) << 32);
+    }
+
+    // Bounds-checked cursor over one record's payload
+    struct Cursor {
+        const char* position;
+        const char* end;
+
+        bool has(size_t bytes) const { return static_cast<size_t>(end - position) >= bytes; }
+
+        bool read_u32(uint32_t& value) {
+            if (!has(4)) return false;
+            value = get_u32(position);
+            position += 4;
+            return true;
+        }
+
+        bool read_string(std::string_view& value) {
+            uint32_t length = 0;
+            if (!read_u32(length) || !has(length)) return false;
+            value = std::string_view(position, length);
+            position += length;
+            return true;
+        }
+
+        bool read_string_list(RecordStringList& list) {
+            uint32_t count = 0;
+            if (!read_u32(count)) return false;
+            const char* first = position;
+            std::string_view ignored;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (!read_string(ignored)) return false;
+            }
+            list = RecordStringList(first, count);
+            return true;
+        }
+
+        bool read_string_ref(const RecordStringTable& table, std::string_view& value) {
+            uint32_t id = 0;
+            if (!read_u32(id) || !table.contains(id)) return false;
+            value = table[id];
+            return true;
+        }
+
+        bool read_string_ref_list(const RecordStringTable& table, RecordStringList& list) {
+            uint32_t count = 0;
+            if (!read_u32(count) || !has(static_cast<size_t>(count) * 4)) return false;
+            const char* first = position;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (!table.contains(get_u32(position + i * 4))) return false;
+            }
+            position += static_cast<size_t>(count) * 4;
+            list = RecordStringList(first, count, &table);
+            return true;
+        }
+    };
+} // end anonymous namespace
+
+std::string_view RecordStringTable::operator[](uint32_t id) const {
+    const char* entry = m_data + get_u64(m_index + static_cast<size_t>(id) * 8);
+    return std::string_view(entry + 4, get_u32(entry));
+}
+
+bool RecordStringTable::contains(uint32_t id) const {
+    if (id >= m_count) return false;
+    uint64_t offset = get_u64(m_index + static_cast<size_t>(id) * 8);
+    uint64_t end = static_cast<uint64_t>(m_index - m_data);
+    return offset <= end && end - offset >= 4 && end - offset - 4 >= get_u32(m_data + offset);
+}
+
+std::string_view RecordStringList::const_iterator::operator*() const {
+    if (m_table) {
+        return (*m_table)[get_u32(m_position)];
+    }
+    return std::string_view(m_position + 4, get_u32(m_position));
+}
+
+RecordStringList::const_iterator& RecordStringList::const_iterator::operator++() {
+    m_position += m_table ? 4 : 4 + get_u32(m_position);
+    --m_remaining;
+    return *this;
+}
+
+std::vector<std::string> RecordStringList::to_vector() const {
+    std::vector<std::string> values;
+    values.reserve(m_count);
+    for (std::string_view value : *this) {
+        values.emplace_back(value);
+    }
+    return values;
+}
+
+int64_t RecordView::fetched_at() const {
+    // Range-checked: converting NaN or an out-of-range double is undefined
+    double seconds = m_doubles[FETCHED_AT];
+    return (seconds > 0.0 && seconds < 9.0e18) ? static_cast<int64_t>(seconds) : 0;
+}
+
+Business RecordView::to_business() const {
+    Business business;
+    business.set_place_id(std::string(place_id()));
+    business.set_name(std::string(name()));
+    business.set_address(std::string(address()));
+    business.set_phone_number(std::string(phone_number()));
+    business.set_email(std::string(email()));
+    business.set_website(std::string(website()));
+    business.set_rating(rating());
+    business.set_total_ratings(total_ratings());
+    business.set_coordinates(latitude(), longitude());
+    business.set_fetched_at(fetched_at());
+    business.set_additional_numbers(additional_numbers().to_vector());
+    business.set_additional_emails(additional_emails().to_vector());
+    business.set_social_media_links(social_media_links().to_vector());
+    return business;
+}
+
+RecordFileWriter::RecordFileWriter()
+    : m_position(0)
+{}
+
+RecordFileWriter::~RecordFileWriter() {
+    // Without close() the file is incomplete: leave it as FILENAME.partial
+    m_file.close();
+}
+
+bool RecordFileWriter::open(const std::string& filename) {
+    m_last_error.clear();
+    m_offsets.clear();
+    m_string_ids.clear();
+    m_strings.clear();
+
+    if (!m_file.open_atomic(filename)) {
+        m_last_error = m_file.last_error();
+        return false;
+    }
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    put_u16(header, RecordFile::VERSION);
+    put_u16(header, 0);
+    put_u32(header, static_cast<uint32_t>(sizeof(FIELDS) / sizeof(FIELDS[0])));
+    for (const auto& field : FIELDS) {
+        size_t name_length = std::strlen(field.name);
+        header += static_cast<char>(field.type);
+        put_u16(header, static_cast<uint16_t>(name_length));
+        header.append(field.name, name_length);
+    }
+
+    m_file.write(header);
+    m_position = header.size();
+    if (!m_file.ok()) {
+        m_last_error = m_file.last_error();
+        return false;
+    }
+    return true;
+}
+
+bool RecordFileWriter::write(const Business& business) {
+    if (!m_file.is_open()) {
+        m_last_error = "Record file is not open";
+        return false;
+    }
+
+    // Fields must be appended in FIELDS order
+    m_record.assign(4, '\0');
+    put_string(m_record, business.place_id());
+    put_string_ref(business.name());
+    put_string(m_record, business.address());
+    put_string(m_record, business.phone_number());
+    put_string_ref(business.email());
+    put_string_ref(business.website());
+
+    put_double(m_record, business.rating());
+    put_u32(m_record, static_cast<uint32_t>(business.total_ratings()));
+    put_double(m_record, business.latitude());
+    put_double(m_record, business.longitude());
+    put_double(m_record, static_cast<double>(business.fetched_at()));
+
+    put_strings(m_record, business.additional_numbers());
+    put_string_refs(business.additional_emails());
+    put_string_refs(business.social_media_links());
+
+    // Patch the payload length into the prefix
+    std::string length;
+    put_u32(length, static_cast<uint32_t>(m_record.size() - 4));
+    m_record.replace(0, 4, length);
+
+    m_offsets.push_back(m_position);
+    m_file.write(m_record);
+    m_position += m_record.size();
+
+    if (!m_file.ok()) {
+        m_last_error = m_file.last_error();
+        return false;
+    }
+    return true;
+}
+
+bool RecordFileWriter::close() {
+    if (!m_file.is_open()) {
+        return m_last_error.empty();
+    }
+    if (!m_last_error.empty()) {
+        // A record is missing: keep the previous FILENAME and leave the .partial file
+        m_file.close();
+        return false;
+    }
+
+    // String table, then its index, then the record index
+    std::string footer;
+    std::vector<uint64_t> string_offsets;
+    string_offsets.reserve(m_strings.size());
+    for (const std::string* value : m_strings) {
+        string_offsets.push_back(m_position + footer.size());
+        put_string(footer, *value);
+    }
+
+    uint64_t strings_index = m_position + footer.size();
+    footer.reserve(footer.size() + (string_offsets.size() + m_offsets.size()) * 8 + TRAILER_SIZE);
+    for (uint64_t offset : string_offsets) {
+        put_u64(footer, offset);
+    }
+
+    uint64_t records_index = m_position + footer.size();
+    for (uint64_t offset : m_offsets) {
+        put_u64(footer, offset);
+    }
+    put_u64(footer, strings_index);
+    put_u64(footer, string_offsets.size());
+    put_u64(footer, records_index);
+    put_u64(footer, m_offsets.size());
+    footer.append(MAGIC, sizeof(MAGIC));
+
+    m_file.write(footer);
+    bool written = m_file.ok();
+    if (!written) {
+        m_file.close();
+    } else if (!m_file.commit()) {
+        written = false;
+    }
+    if (!written) {
+        m_last_error = m_file.last_error();
+        return false;
+    }
+    return true;
+}
+
+void RecordFileWriter::put_string_ref(const std::string& value) {
+    auto inserted = m_string_ids.emplace(value, static_cast<uint32_t>(m_strings.size()));
+    if (inserted.second) {
+        m_strings.push_back(&inserted.first->first);
+    }
+    put_u32(m_record, inserted.first->second);
+}
+
+void RecordFileWriter::put_string_refs(const std::vector<std::string>& values) {
+    put_u32(m_record, static_cast<uint32_t>(values.size()));
+    for (const auto& value : values) {
+        put_string_ref(value);
+    }
+}
+
+RecordFileReader::RecordFileReader()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_index(nullptr)
+    , m_record_count(0)
+    , m_version(0)
+#ifdef _WIN32
+    , m_file_handle(nullptr)
+    , m_mapping_handle(nullptr)
+#endif
+{}
+
+RecordFileReader::~RecordFileReader() {
+    close();
+}
+
+bool RecordFileReader::open(const std::string& filename) {
+    close();
+    m_last_error.clear();
+
+    if (!map_file(filename)) {
+        return false;
+    }
+
+    if (!parse_layout()) {
+        m_last_error = "Not a valid record file: " + filename + (m_last_error.empty() ? "" : " (" + m_last_error + ")");
+        close();
+        return false;
+    }
+    return true;
+}
+
+void RecordFileReader::close() {
+    unmap_file();
+    m_index = nullptr;
+    m_record_count = 0;
+    m_version = 0;
+    m_strings = RecordStringTable();
+    m_schema.clear();
+}
+
+bool RecordFileReader::read(size_t index, RecordView& view) const {
+    if (index >= m_record_count) {
+        m_last_error = "Record index out of range";
+        return false;
+    }
+
+    uint64_t offset = get_u64(m_index + index * 8);
+    if (offset > m_size || m_size - offset < 4) {
+        m_last_error = "Record offset out of range";
+        return false;
+    }
+
+    uint32_t length = get_u32(m_data + offset);
+    if (length > m_size - offset - 4) {
+        m_last_error = "Record length out of range";
+        return false;
+    }
+
+    view = RecordView();
+    Cursor cursor{m_data + offset + 4, m_data + offset + 4 + length};
+
+    for (const auto& field : m_schema) {
+        bool ok = true;
+        switch (field.type) {
+            case TYPE_STRING: {
+                std::string_view value;
+                ok = cursor.read_string(value);
+                if (ok && field.slot >= 0) view.m_strings[field.slot] = value;
+                break;
+            }
+            case TYPE_DOUBLE: {
+                ok = cursor.has(8);
+                if (ok && field.slot >= 0) {
+                    uint64_t bits = get_u64(cursor.position);
+                    std::memcpy(&view.m_doubles[field.slot], &bits, sizeof(bits));
+                }
+                cursor.position += ok ? 8 : 0;
+                break;
+            }
+            case TYPE_INT32: {
+                uint32_t value = 0;
+                ok = cursor.read_u32(value);
+                if (ok && field.slot >= 0) view.m_total_ratings = static_cast<int32_t>(value);
+                break;
+            }
+            case TYPE_STRING_LIST: {
+                RecordStringList list;
+                ok = cursor.read_string_list(list);
+                if (ok && field.slot >= 0) view.m_lists[field.slot] = list;
+                break;
+            }
+            case TYPE_STRING_REF: {
+                std::string_view value;
+                ok = cursor.read_string_ref(m_strings, value);
+                if (ok && field.slot >= 0) view.m_strings[field.slot] = value;
+                break;
+            }
+            case TYPE_STRING_REF_LIST: {
+                RecordStringList list;
+                ok = cursor.read_string_ref_list(m_strings, list);
+                if (ok && field.slot >= 0) view.m_lists[field.slot] = list;
+                break;
+            }
+            default:
+                ok = false;
+                break;
+        }
+
+        if (!ok) {
+            m_last_error = "Record " + std::to_string(index) + " is truncated or has a bad string reference";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RecordFileReader::parse_layout() {
+    if (m_size < HEADER_SIZE + TRAILER_SIZE_V1 || std::memcmp(m_data, MAGIC, sizeof(MAGIC)) != 0 ||
+        std::memcmp(m_data + m_size - sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0) {
+        m_last_error = "missing header or trailer";
+        return false;
+    }
+
+    m_version = get_u16(m_data + 4);
+    if (m_version == 0 || m_version > RecordFile::VERSION) {
+        m_last_error = "unsupported version " + std::to_string(m_version);
+        return false;
+    }
+
+    const size_t trailer_size = m_version == 1 ? TRAILER_SIZE_V1 : TRAILER_SIZE;
+    if (m_size < HEADER_SIZE + trailer_size) {
+        m_last_error = "missing header or trailer";
+        return false;
+    }
+
+    // Map the file's schema onto the fields this version understands
+    uint32_t field_count = get_u32(m_data + 8);
+    const char* position = m_data + HEADER_SIZE;
+    const char* end = m_data + m_size - trailer_size;
+    for (uint32_t i = 0; i < field_count; ++i) {
+        if (end - position < 3) {
+            m_last_error = "truncated schema";
+            return false;
+        }
+        uint8_t type = static_cast<uint8_t>(position[0]);
+        uint16_t name_length = get_u16(position + 1);
+        position += 3;
+        if (end - position < name_length || type > TYPE_STRING_REF_LIST) {
+            m_last_error = "invalid schema";
+            return false;
+        }
+        std::string_view name(position, name_length);
+        position += name_length;
+
+        SchemaField field{type, -1};
+        for (const auto& known : FIELDS) {
+            if (name == known.name && slot_kind(type) == slot_kind(known.type)) {
+                field.slot = known.slot;
+                break;
+            }
+        }
+        m_schema.push_back(field);
+    }
+
+    // Version 1 has no string table: its trailer starts at the record index offset
+    const char* trailer = m_data + m_size - trailer_size;
+    const uint64_t schema_end = static_cast<uint64_t>(position - m_data);
+    uint64_t strings_index = schema_end;
+    uint64_t string_count = 0;
+    if (m_version > 1) {
+        strings_index = get_u64(trailer);
+        string_count = get_u64(trailer + 8);
+        trailer += 16;
+    }
+    uint64_t index_offset = get_u64(trailer);
+    uint64_t record_count = get_u64(trailer + 8);
+
+    const uint64_t index_end = m_size - trailer_size;
+    if (m_version > 1 && (strings_index < schema_end || strings_index > index_offset ||
+                          (index_offset - strings_index) % 8 != 0 || (index_offset - strings_index) / 8 != string_count)) {
+        m_last_error = "corrupt string table";
+        return false;
+    }
+    if (index_offset < schema_end || index_offset > index_end || record_count != (index_end - index_offset) / 8) {
+        m_last_error = "corrupt index";
+        return false;
+    }
+
+    m_strings.m_data = m_data;
+    m_strings.m_index = m_data + strings_index;
+    m_strings.m_count = static_cast<size_t>(string_count);
+    m_index = m_data + index_offset;
+    m_record_count = static_cast<size_t>(record_count);
+    return true;
+}
+
+#ifdef _WIN32
+
+bool RecordFileReader::map_file(const std::string& filename) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        m_last_error = "Could not open record file: " + filename;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        m_last_error = "Record file is empty: " + filename;
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        m_last_error = "Could not map record file: " + filename;
+        return false;
+    }
+
+    m_file_handle = file;
+    m_mapping_handle = mapping;
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void RecordFileReader::unmap_file() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping_handle);
+        CloseHandle(m_file_handle);
+        m_file_handle = nullptr;
+        m_mapping_handle = nullptr;
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#else
+
+bool RecordFileReader::map_file(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        m_last_error = "Could not open record file: " + filename;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        m_last_error = "Record file is empty: " + filename;
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        m_last_error = "Could not map record file: " + filename;
+        return false;
+    }
+
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void RecordFileReader::unmap_file() {
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
@@ -0,0 +1,392 @@
+#include "storage/ResultStore.h"
+#include "core/EntityResolver.h"
+#include <sqlite3.h>
+#include <filesystem>
+
+namespace {
+    const int SCHEMA_VERSION = 1;
+
+    const char* const SCHEMA_SQL =
+        "CREATE TABLE IF NOT EXISTS businesses ("
+        " record_key TEXT PRIMARY KEY,"
+        " place_id TEXT NOT NULL,"
+        " name TEXT NOT NULL,"
+        " address TEXT NOT NULL,"
+        " phone_number TEXT NOT NULL,"
+        " email TEXT NOT NULL,"
+        " website TEXT NOT NULL,"
+        " rating REAL NOT NULL,"
+        " total_ratings INTEGER NOT NULL,"
+        " latitude REAL,"
+        " longitude REAL,"
+        " fetched_at INTEGER NOT NULL,"
+        " additional_numbers TEXT NOT NULL,"
+        " additional_emails TEXT NOT NULL,"
+        " social_media_links TEXT NOT NULL,"
+        " name_key TEXT NOT NULL,"
+        " phone_key TEXT NOT NULL,"
+        " domain_key TEXT NOT NULL);";
+
+    const char* const CREATE_INDICES_SQL =
+        "CREATE INDEX IF NOT EXISTS businesses_name ON businesses(name_key);"
+        "CREATE INDEX IF NOT EXISTS businesses_phone ON businesses(phone_key);"
+        "CREATE INDEX IF NOT EXISTS businesses_domain ON businesses(domain_key);";
+
+    const char* const DROP_INDICES_SQL =
+        "DROP INDEX IF EXISTS businesses_name;"
+        "DROP INDEX IF EXISTS businesses_phone;"
+        "DROP INDEX IF EXISTS businesses_domain;";
+
+    // Website-derived fields missing from the new record keep their stored values
+    const char* const UPSERT_SQL =
+        "INSERT INTO businesses (record_key, place_id, name, address, phone_number, email, website,"
+        " rating, total_ratings, latitude, longitude, fetched_at,"
+        " additional_numbers, additional_emails, social_media_links, name_key, phone_key, domain_key)"
+        " VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16, ?17, ?18)"
+        " ON CONFLICT(record_key) DO UPDATE SET"
+        " place_id = excluded.place_id,"
+        " name = excluded.name,"
+        " address = excluded.address,"
+        " phone_number = excluded.phone_number,"
+        " email = COALESCE(NULLIF(excluded.email, ''), email),"
+        " website = COALESCE(NULLIF(excluded.website, ''), website),"
+        " rating = excluded.rating,"
+        " total_ratings = excluded.total_ratings,"
+        " latitude = COALESCE(excluded.latitude, latitude),"
+        " longitude = COALESCE(excluded.longitude, longitude),"
+        " fetched_at = MAX(excluded.fetched_at, fetched_at),"
+        " additional_numbers = COALESCE(NULLIF(excluded.additional_numbers, ''), additional_numbers),"
+        " additional_emails = COALESCE(NULLIF(excluded.additional_emails, ''), additional_emails),"
+        " social_media_links = COALESCE(NULLIF(excluded.social_media_links, ''), social_media_links),"
+        " name_key = excluded.name_key,"
+        " phone_key = excluded.phone_key,"
+        " domain_key = CASE WHEN excluded.website <> '' THEN excluded.domain_key ELSE domain_key END";
+
+    const char* const SELECT_SQL =
+        "SELECT place_id, name, address, phone_number, email, website, rating, total_ratings,"
+        " latitude, longitude, fetched_at, additional_numbers, additional_emails, social_media_links"
+        " FROM businesses WHERE 1";
+
+    // List fields are stored one value per line
+    const char LIST_SEPARATOR = '\n';
+
+    std::string join_list(const std::vector<std::string>& values) {
+        std::string joined;
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) joined += LIST_SEPARATOR;
+            joined += values[i];
+        }
+        return joined;
+    }
+
+    std::vector<std::string> split_list(const char* text) {
+        std::vector<std::string> values;
+        if (!text || !*text) return values;
+
+        std::string_view remaining(text);
+        while (true) {
+            size_t end = remaining.find(LIST_SEPARATOR);
+            values.emplace_back(remaining.substr(0, end));
+            if (end == std::string_view::npos) break;
+            remaining.remove_prefix(end + 1);
+        }
+        return values;
+    }
+
+    void bind_text(sqlite3_stmt* statement, int index, const std::string& value) {
+        sqlite3_bind_text(statement, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+    }
+
+    std::string column_text(sqlite3_stmt* statement, int index) {
+        const unsigned char* text = sqlite3_column_text(statement, index);
+        return text ? std::string(reinterpret_cast<const char*>(text)) : std::string();
+    }
+}
+
+ResultStore::ResultStore()
+    : m_db(nullptr)
+    , m_upsert(nullptr)
+    , m_pending(0)
+    , m_bulk(false)
+{}
+
+ResultStore::~ResultStore() {
+    close();
+}
+
+bool ResultStore::open(const std::string& filename) {
+    close();
+    m_last_error.clear();
+
+    std::error_code error;
+    std::filesystem::path file_path(filename);
+    if (file_path.has_parent_path()) {
+        std::filesystem::create_directories(file_path.parent_path(), error);
+    }
+
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(filename.c_str(), &m_db, flags, nullptr) != SQLITE_OK) {
+        fail("Cannot open " + filename);
+        close();
+        return false;
+    }
+
+    // Wait for a concurrent writer (the GUI and CLI may share a store) instead of failing at once
+    sqlite3_busy_timeout(m_db, 5000);
+
+    // Larger pages mean fewer B-tree splits on bulk loads; they only apply to a
+    // new file and must be set before it switches to WAL
+    if (!execute("PRAGMA page_size=16384") || !execute("PRAGMA journal_mode=WAL") ||
+        !execute("PRAGMA synchronous=NORMAL")) {
+        close();
+        return false;
+    }
+
+    sqlite3_stmt* statement = nullptr;
+    int version = 0;
+    if (sqlite3_prepare_v2(m_db, "PRAGMA user_version", -1, &statement, nullptr) == SQLITE_OK &&
+        sqlite3_step(statement) == SQLITE_ROW) {
+        version = sqlite3_column_int(statement, 0);
+    }
+    sqlite3_finalize(statement);
+
+    if (version > SCHEMA_VERSION) {
+        m_last_error = filename + " was written by a newer version (schema " + std::to_string(version) + ")";
+        close();
+        return false;
+    }
+
+    // Recreates indices a bulk load interrupted by a crash left dropped
+    if (!execute(SCHEMA_SQL) || !execute(CREATE_INDICES_SQL) ||
+        !execute(("PRAGMA user_version=" + std::to_string(SCHEMA_VERSION)).c_str())) {
+        close();
+        return false;
+    }
+
+    if (sqlite3_prepare_v2(m_db, UPSERT_SQL, -1, &m_upsert, nullptr) != SQLITE_OK) {
+        fail("Cannot prepare upsert");
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ResultStore::close() {
+    if (!m_db) return;
+
+    end_bulk();
+    commit();
+    sqlite3_finalize(m_upsert);
+    m_upsert = nullptr;
+    sqlite3_close(m_db);
+    m_db = nullptr;
+}
+
+bool ResultStore::upsert(const Business& business) {
+    if (!m_db) {
+        m_last_error = "Store is not open";
+        return false;
+    }
+
+    if (sqlite3_get_autocommit(m_db) && !execute("BEGIN")) {
+        return false;
+    }
+
+    std::string record_key = business.place_id();
+    if (record_key.empty()) {
+        // Place IDs never contain this separator, so the two kinds of key cannot collide
+        record_key = "\x1F" + EntityResolver::normalize_name(business.name()) + "\x1F" +
+                     EntityResolver::normalize_address(business.address());
+    }
+    std::string additional_numbers = join_list(business.additional_numbers());
+    std::string additional_emails = join_list(business.additional_emails());
+    std::string social_media_links = join_list(business.social_media_links());
+    std::string name_key = EntityResolver::normalize_name(business.name());
+    std::string phone_key = EntityResolver::normalize_phone(business.phone_number());
+    std::string domain_key = EntityResolver::normalize_domain(business.website());
+
+    bind_text(m_upsert, 1, record_key);
+    bind_text(m_upsert, 2, business.place_id());
+    bind_text(m_upsert, 3, business.name());
+    bind_text(m_upsert, 4, business.address());
+    bind_text(m_upsert, 5, business.phone_number());
+    bind_text(m_upsert, 6, business.email());
+    bind_text(m_upsert, 7, business.website());
+    sqlite3_bind_double(m_upsert, 8, business.rating());
+    sqlite3_bind_int(m_upsert, 9, business.total_ratings());
+    if (business.has_coordinates()) {
+        sqlite3_bind_double(m_upsert, 10, business.latitude());
+        sqlite3_bind_double(m_upsert, 11, business.longitude());
+    } else {
+        sqlite3_bind_null(m_upsert, 10);
+        sqlite3_bind_null(m_upsert, 11);
+    }
+    sqlite3_bind_int64(m_upsert, 12, business.fetched_at());
+    bind_text(m_upsert, 13, additional_numbers);
+    bind_text(m_upsert, 14, additional_emails);
+    bind_text(m_upsert, 15, social_media_links);
+    bind_text(m_upsert, 16, name_key);
+    bind_text(m_upsert, 17, phone_key);
+    bind_text(m_upsert, 18, domain_key);
+
+    int status = sqlite3_step(m_upsert);
+    sqlite3_reset(m_upsert);
+    if (status != SQLITE_DONE) {
+        // Discard the batch rather than leave a half-written transaction open
+        fail("Cannot store " + business.name());
+        std::string error = m_last_error;
+        execute("ROLLBACK");
+        m_pending = 0;
+        m_last_error = error;
+        return false;
+    }
+
+    if (++m_pending >= BATCH_SIZE) {
+        return commit();
+    }
+    return true;
+}
+
+bool ResultStore::upsert(const std::vector<Business>& businesses) {
+    if (!begin_bulk(businesses.size())) {
+        return false;
+    }
+    for (const auto& business : businesses) {
+        if (!upsert(business)) {
+            end_bulk();
+            return false;
+        }
+    }
+    return end_bulk();
+}
+
+bool ResultStore::begin_bulk(size_t expected_records) {
+    if (!m_db) {
+        m_last_error = "Store is not open";
+        return false;
+    }
+
+    // Maintaining an index costs about as much per row as the insert itself,
+    // while rebuilding it is one sort of the whole table, so dropping pays off
+    // once the load is large next to what is already stored
+    if (m_bulk || expected_records < BATCH_SIZE || expected_records < count() / 2) {
+        return true;
+    }
+    if (!execute(DROP_INDICES_SQL)) {
+        return false;
+    }
+    m_bulk = true;
+    return true;
+}
+
+bool ResultStore::end_bulk() {
+    if (!m_bulk) {
+        return true;
+    }
+    m_bulk = false;
+    return execute(CREATE_INDICES_SQL) && commit();
+}
+
+bool ResultStore::commit() {
+    m_pending = 0;
+    if (!m_db || sqlite3_get_autocommit(m_db)) {
+        return true;
+    }
+    return execute("COMMIT");
+}
+
+bool ResultStore::query(const StoreQuery& query, std::vector<Business>& businesses) {
+    if (!m_db) {
+        m_last_error = "Store is not open";
+        return false;
+    }
+
+    // A filter that normalises to nothing ("123" as a phone) can match no record
+    std::string name_key = EntityResolver::normalize_name(query.name);
+    std::string phone_key = EntityResolver::normalize_phone(query.phone);
+    std::string domain_key = EntityResolver::normalize_domain(query.domain);
+    if ((!query.name.empty() && name_key.empty()) || (!query.phone.empty() && phone_key.empty()) ||
+        (!query.domain.empty() && domain_key.empty())) {
+        return true;
+    }
+
+    // The prefix is a range over the name index; no UTF-8 string contains 0xFF
+    std::string name_end = name_key + "\xFF";
+
+    std::string sql = SELECT_SQL;
+    if (!name_key.empty()) sql += " AND name_key >= ?1 AND name_key < ?2";
+    if (!phone_key.empty()) sql += " AND phone_key = ?3";
+    if (!domain_key.empty()) sql += " AND domain_key = ?4";
+    sql += " ORDER BY rowid";
+    if (query.limit > 0) sql += " LIMIT ?5";
+
+    sqlite3_stmt* statement = nullptr;
+    if (sqlite3_prepare_v2(m_db, sql.c_str(), -1, &statement, nullptr) != SQLITE_OK) {
+        return fail("Cannot prepare query");
+    }
+
+    if (!name_key.empty()) {
+        bind_text(statement, 1, name_key);
+        bind_text(statement, 2, name_end);
+    }
+    if (!phone_key.empty()) bind_text(statement, 3, phone_key);
+    if (!domain_key.empty()) bind_text(statement, 4, domain_key);
+    if (query.limit > 0) sqlite3_bind_int64(statement, 5, static_cast<sqlite3_int64>(query.limit));
+
+    int status;
+    while ((status = sqlite3_step(statement)) == SQLITE_ROW) {
+        Business business;
+        business.set_place_id(column_text(statement, 0));
+        business.set_name(column_text(statement, 1));
+        business.set_address(column_text(statement, 2));
+        business.set_phone_number(column_text(statement, 3));
+        business.set_email(column_text(statement, 4));
+        business.set_website(column_text(statement, 5));
+        business.set_rating(sqlite3_column_double(statement, 6));
+        business.set_total_ratings(sqlite3_column_int(statement, 7));
+        if (sqlite3_column_type(statement, 8) != SQLITE_NULL && sqlite3_column_type(statement, 9) != SQLITE_NULL) {
+            business.set_coordinates(sqlite3_column_double(statement, 8), sqlite3_column_double(statement, 9));
+        }
+        business.set_fetched_at(sqlite3_column_int64(statement, 10));
+        business.set_additional_numbers(split_list(reinterpret_cast<const char*>(sqlite3_column_text(statement, 11))));
+        business.set_additional_emails(split_list(reinterpret_cast<const char*>(sqlite3_column_text(statement, 12))));
+        business.set_social_media_links(split_list(reinterpret_cast<const char*>(sqlite3_column_text(statement, 13))));
+        businesses.push_back(std::move(business));
+    }
+
+    sqlite3_finalize(statement);
+    if (status != SQLITE_DONE) {
+        return fail("Query failed");
+    }
+    return true;
+}
+
+size_t ResultStore::count() {
+    if (!m_db) return 0;
+
+    sqlite3_stmt* statement = nullptr;
+    size_t records = 0;
+    if (sqlite3_prepare_v2(m_db, "SELECT COUNT(*) FROM businesses", -1, &statement, nullptr) == SQLITE_OK &&
+        sqlite3_step(statement) == SQLITE_ROW) {
+        records = static_cast<size_t>(sqlite3_column_int64(statement, 0));
+    } else {
+        fail("Cannot count records");
+    }
+    sqlite3_finalize(statement);
+    return records;
+}
+
+bool ResultStore::execute(const char* sql) {
+    char* message = nullptr;
+    if (sqlite3_exec(m_db, sql, nullptr, nullptr, &message) != SQLITE_OK) {
+        m_last_error = std::string(sql) + ": " + (message ? message : "unknown error");
+        sqlite3_free(message);
+        return false;
+    }
+    return true;
+}
+
+bool ResultStore::fail(const std::string& context) {
+    m_last_error = context + ": " + (m_db ? sqlite3_errmsg(m_db) : "out of memory");
+    return false;
+}
@@ -56,6 +56,94 @@ bool FileUtils::directory_exists(const std::string& directory_path) {
     return std::filesystem::exists(directory_path) && std::filesystem::is_directory(directory_path);
 }
 
+bool FileUtils::read_csv_file(const std::string& filename, std::vector<std::vector<std::string>>& rows,
+                              std::vector<size_t>* line_numbers) {
+    clear_error();
+    rows.clear();
+    if (line_numbers) {
+        line_numbers->clear();
+    }
+
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        set_error("Could not open file: " + filename);
+        return false;
+    }
+
+    std::vector<std::string> row;
+    std::string field;
+    bool in_quotes = false;
+    bool row_has_data = false;
+    size_t line = 1;
+    size_t row_line = 1;
+    char c;
+
+    // Called on the row's closing newline, so the next row starts on the next line
+    auto end_row = [&]() {
+        if (row_has_data) {
+            row.push_back(field);
+            rows.push_back(row);
+            if (line_numbers) {
+                line_numbers->push_back(row_line);
+            }
+        }
+        row.clear();
+        field.clear();
+        row_has_data = false;
+        row_line = line + 1;
+    };
+
+    while (file.get(c)) {
+        if (in_quotes) {
+            if (c == '\n') {
+                ++line;
+            }
+            if (c == '"') {
+                // Doubled quote is an escaped quote, otherwise the quoted section ends
+                if (file.peek() == '"') {
+                    file.get(c);
+                    field += '"';
+                } else {
+                    in_quotes = false;
+                }
+            } else {
+                field += c;
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"':
+                in_quotes = true;
+                row_has_data = true;
+                break;
+            case ',':
+                row.push_back(field);
+                field.clear();
+                row_has_data = true;
+                break;
+            case '\r':
+                break;
+            case '\n':
+                end_row();
+                ++line;
+                break;
+            default:
+                field += c;
+                row_has_data = true;
+                break;
+        }
+    }
+    end_row();
+
+    if (in_quotes) {
+        set_error("Unterminated quoted field in: " + filename);
+        return false;
+    }
+
+    return true;
+}
+
 std::string FileUtils::get_timestamp_string() {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -75,6 +163,8 @@ std::string FileUtils::get_file_extension(OutputFormat format) {
             return "yml";
         case OutputFormat::XML:
             return "xml";
+        case OutputFormat::JSONL:
+            return "jsonl";
         default:
             return "csv";
     }
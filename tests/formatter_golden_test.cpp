@@ -0,0 +1,162 @@
+// Formats records with edge-case numbers in every output format and compares
+// the bytes with the golden files in GOLDEN_DIR. Ratings must come out as the
+// shortest text that reads back as the same double and total ratings as plain
+// integers, whatever the C locale: the comparison is repeated under a
+// comma-decimal locale when the host has one.
+//
+// Usage: formatter_golden_test GOLDEN_DIR [--update]
+// --update rewrites the golden files from the current output.
+#include "output/Formatter.h"
+#include <cfloat>
+#include <climits>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    struct GoldenFile {
+        OutputFormat format;
+        const char* name;
+    };
+
+    const GoldenFile FILES[] = {
+        {OutputFormat::CSV, "numbers.csv"},
+        {OutputFormat::JSON, "numbers.json"},
+        {OutputFormat::YAML, "numbers.yaml"},
+        {OutputFormat::XML, "numbers.xml"},
+        {OutputFormat::JSONL, "numbers.jsonl"},
+    };
+
+    std::vector<Business> make_businesses() {
+        struct Numbers {
+            double rating;
+            int total_ratings;
+        };
+        const Numbers NUMBERS[] = {
+            {0.0, 0},
+            {4.5, 1},
+            {0.1, 10},
+            {1.1 * 3, -1},                        // 3.3000000000000003; %g printed 3.3
+            {1e-07, 1000000},
+            {1e+21, INT_MAX},
+            {-0.0, INT_MIN},
+            {5e-324, 7},                          // Smallest denormal
+            {2.2250738585072009e-308, 8},         // Largest denormal
+            {DBL_MAX, 9},
+            {123456789.125, 42},
+        };
+
+        std::vector<Business> businesses;
+        int index = 0;
+        for (const Numbers& numbers : NUMBERS) {
+            Business business;
+            business.set_name("Business " + std::to_string(++index));
+            business.set_address(std::to_string(index) + " Main St, Berlin");
+            business.set_rating(numbers.rating);
+            business.set_total_ratings(numbers.total_ratings);
+            businesses.push_back(business);
+        }
+        businesses[1].set_phone_number("+49 30 1234567");
+        businesses[1].set_website("https://example.com/");
+        businesses[1].set_additional_emails({"a@example.com", "b@example.com"});
+        return businesses;
+    }
+
+    bool read_file(const std::string& path, std::string& content) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        content = buffer.str();
+        return true;
+    }
+
+    // Compares every format with its golden file; returns the failure count
+    int compare_all(const std::vector<Business>& businesses, const std::string& golden_dir, const char* context) {
+        int failures = 0;
+        for (const GoldenFile& golden : FILES) {
+            std::string path = golden_dir + "/" + golden.name;
+            std::string expected;
+            if (!read_file(path, expected)) {
+                std::cerr << "Cannot read golden file: " << path << std::endl;
+                ++failures;
+                continue;
+            }
+
+            std::string actual = Formatter(golden.format).format_businesses(businesses);
+            if (actual != expected) {
+                size_t offset = 0;
+                while (offset < actual.size() && offset < expected.size() && actual[offset] == expected[offset]) {
+                    ++offset;
+                }
+                std::cerr << golden.name << " differs (" << context << ") at byte " << offset << ": expected \""
+                          << expected.substr(offset, 40) << "\", got \"" << actual.substr(offset, 40) << "\"" << std::endl;
+                ++failures;
+            }
+        }
+        return failures;
+    }
+
+    // Switches the C and C++ locales to one that writes "4,5"; false if none is installed
+    bool use_comma_locale() {
+        const char* const NAMES[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR"};
+        for (const char* name : NAMES) {
+            if (std::setlocale(LC_ALL, name) && std::strcmp(std::localeconv()->decimal_point, ",") == 0) {
+                try {
+                    std::locale::global(std::locale(name));
+                } catch (const std::runtime_error&) {
+                    // The C locale alone is what snprintf-style formatting follows
+                }
+                return true;
+            }
+        }
+        std::setlocale(LC_ALL, "C");
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " GOLDEN_DIR [--update]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string golden_dir = argv[1];
+    const std::vector<Business> businesses = make_businesses();
+
+    if (argc > 2 && std::string(argv[2]) == "--update") {
+        for (const GoldenFile& golden : FILES) {
+            std::string path = golden_dir + "/" + golden.name;
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << Formatter(golden.format).format_businesses(businesses);
+            if (!file) {
+                std::cerr << "Cannot write golden file: " << path << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        std::cout << "Golden files updated in " << golden_dir << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    int failures = compare_all(businesses, golden_dir, "C locale");
+
+    if (use_comma_locale()) {
+        failures += compare_all(businesses, golden_dir, std::setlocale(LC_ALL, nullptr));
+        std::setlocale(LC_ALL, "C");
+    } else {
+        std::cout << "No comma-decimal locale installed; checked the C locale only" << std::endl;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " golden comparisons failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All formats match the golden files" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+// Appends records to a ResultSpill with a small memory budget and checks that
+// for_each returns every one of them in order: when the spill file works, and
+// when writing it fails part-way (simulated with a file size limit, which makes
+// write() fail as a full disk would).
+#include "core/ResultSpill.h"
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+namespace {
+    constexpr size_t RECORD_COUNT = 2000;
+    constexpr size_t MEMORY_BUDGET = 4096;
+
+    int failures = 0;
+
+    void fail(const std::string& message) {
+        std::cerr << message << std::endl;
+        ++failures;
+    }
+
+    std::string spill_filename(const char* name) {
+        return (std::filesystem::temp_directory_path() / (std::string("result_spill_test_") + name + ".spill")).string();
+    }
+
+    void fill(ResultSpill& spill) {
+        for (size_t i = 0; i < RECORD_COUNT; ++i) {
+            Business business;
+            business.set_place_id("place_" + std::to_string(i));
+            business.set_name("Business " + std::to_string(i));
+            business.set_address(std::to_string(i) + " Main St, Berlin");
+            business.set_rating(4.5);
+            business.set_social_media_links({"https://example.com/" + std::to_string(i)});
+            spill.append(std::move(business));
+        }
+    }
+
+    // Every record comes back once, in the order it was appended
+    void check_read_back(ResultSpill& spill, const char* context) {
+        size_t count = 0;
+        bool ordered = true;
+        bool read = spill.for_each([&](const Business& business) {
+            ordered = ordered && business.place_id() == "place_" + std::to_string(count) &&
+                      business.social_media_links().size() == 1;
+            ++count;
+        });
+        if (!read) {
+            fail(std::string(context) + ": for_each failed: " + spill.last_error());
+        } else if (count != RECORD_COUNT || !ordered) {
+            fail(std::string(context) + ": read back " + std::to_string(count) + " of " +
+                 std::to_string(RECORD_COUNT) + " records" + (ordered ? "" : ", out of order"));
+        }
+    }
+
+    void test_spilled() {
+        ResultSpill spill(spill_filename("spilled"), MEMORY_BUDGET);
+        fill(spill);
+        if (!spill.last_error().empty()) {
+            fail("spilled: unexpected error: " + spill.last_error());
+        }
+        if (spill.buffered_bytes() > MEMORY_BUDGET) {
+            fail("spilled: " + std::to_string(spill.buffered_bytes()) + " bytes buffered over the budget");
+        }
+        check_read_back(spill, "spilled");
+    }
+
+    void test_write_failure() {
+#ifndef _WIN32
+        // Writes beyond 16 KB fail with EFBIG instead of raising SIGXFSZ
+        std::signal(SIGXFSZ, SIG_IGN);
+        rlimit previous;
+        getrlimit(RLIMIT_FSIZE, &previous);
+        rlimit limit = previous;
+        limit.rlim_cur = 16 * 1024;
+        setrlimit(RLIMIT_FSIZE, &limit);
+
+        ResultSpill spill(spill_filename("write_failure"), MEMORY_BUDGET);
+        fill(spill);
+        setrlimit(RLIMIT_FSIZE, &previous);
+
+        if (spill.last_error().empty()) {
+            fail("write failure: no error reported");
+        }
+        check_read_back(spill, "write failure");
+#endif
+    }
+}
+
+int main() {
+    test_spilled();
+    test_write_failure();
+
+    if (failures > 0) {
+        std::cerr << failures << " spill checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Spilled records read back complete and in order" << std::endl;
+    return EXIT_SUCCESS;
+}
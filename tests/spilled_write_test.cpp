@@ -0,0 +1,134 @@
+// Writes a spilled result set through BusinessScraperEngine::write_results with
+// several formatter threads and checks that the memory it allocates on top of
+// the spill stays within the spill's memory budget, whatever the core count.
+// Live heap bytes are tracked by replacing the global operator new and delete.
+#include "core/BusinessScraperEngine.h"
+#include "core/ResultSpill.h"
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace {
+    std::atomic<size_t> live_bytes(0);
+    std::atomic<size_t> peak_bytes(0);
+
+    // Each block starts with its size, padded to keep the payload aligned
+    constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+    void* allocate(size_t size) {
+        void* block = std::malloc(size + HEADER_SIZE);
+        if (!block) throw std::bad_alloc();
+        *static_cast<size_t*>(block) = size;
+
+        size_t live = live_bytes.fetch_add(size) + size;
+        size_t peak = peak_bytes.load();
+        while (live > peak && !peak_bytes.compare_exchange_weak(peak, live)) {
+        }
+        return static_cast<char*>(block) + HEADER_SIZE;
+    }
+
+    void release(void* pointer) {
+        if (!pointer) return;
+        void* block = static_cast<char*>(pointer) - HEADER_SIZE;
+        live_bytes.fetch_sub(*static_cast<size_t*>(block));
+        std::free(block);
+    }
+
+    // Counts the output and throws it away
+    class NullSink : public OutputSink {
+    public:
+        size_t bytes = 0;
+
+    protected:
+        bool write_through(const char*, size_t size) override {
+            bytes += size;
+            return true;
+        }
+    };
+
+    constexpr size_t RECORD_COUNT = 200000;
+    constexpr size_t MEMORY_BUDGET = 16 * 1024 * 1024;
+    constexpr size_t OUTPUT_THREADS = 8;
+
+    struct NamedFormat {
+        OutputFormat format;
+        const char* name;
+    };
+
+    const NamedFormat FORMATS[] = {
+        {OutputFormat::JSON, "json"},
+        {OutputFormat::XML, "xml"},
+        {OutputFormat::YAML, "yaml"},
+        {OutputFormat::CSV, "csv"},
+    };
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer); }
+
+int main() {
+    const std::string spill_filename =
+        (std::filesystem::temp_directory_path() / "spilled_write_test.spill").string();
+
+    int failures = 0;
+    {
+        SearchResults results;
+        results.success = true;
+        results.spill = std::make_shared<ResultSpill>(spill_filename, MEMORY_BUDGET);
+        for (size_t i = 0; i < RECORD_COUNT; ++i) {
+            Business business;
+            business.set_place_id("ChIJ" + std::to_string(i * 7919) + "place_identifier");
+            business.set_name("Business number " + std::to_string(i));
+            business.set_address(std::to_string(i % 900) + " Long Street Name, 10115 Berlin, Germany");
+            business.set_phone_number("+49 30 " + std::to_string(1000000 + i));
+            business.set_website("https://business-" + std::to_string(i) + ".example.com/");
+            business.set_rating(4.5);
+            business.set_total_ratings(static_cast<int>(i % 5000));
+            business.set_additional_emails({"info@business-" + std::to_string(i) + ".example.com"});
+            results.spill->append(std::move(business));
+        }
+        results.total_found = static_cast<int>(RECORD_COUNT);
+        if (!results.spill->last_error().empty()) {
+            std::cerr << "Spill failed: " << results.spill->last_error() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        BusinessScraperEngine engine;
+        engine.set_output_threads(OUTPUT_THREADS);
+
+        for (const NamedFormat& format : FORMATS) {
+            NullSink sink;
+            const size_t baseline = live_bytes.load();
+            peak_bytes.store(baseline);
+
+            bool written = engine.write_results(results, format.format, sink) && sink.flush();
+            const size_t used = peak_bytes.load() - baseline;
+            std::cout << format.name << ": " << sink.bytes << " bytes written, "
+                      << used / 1024 << " KB allocated at peak, budget " << MEMORY_BUDGET / 1024 << " KB" << std::endl;
+
+            if (!written) {
+                std::cerr << format.name << ": write_results failed" << std::endl;
+                ++failures;
+            } else if (used > MEMORY_BUDGET) {
+                std::cerr << format.name << ": spilled write used " << used << " bytes, over the " << MEMORY_BUDGET
+                          << " byte budget" << std::endl;
+                ++failures;
+            }
+        }
+    }
+    std::filesystem::remove(spill_filename);
+
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+    std::cout << "Spilled writes stay within the memory budget" << std::endl;
+    return EXIT_SUCCESS;
+}